@@ -182,6 +182,10 @@ export class RuntimeLoader {
     rc.default({
       // Loads Wasm bundle
       locateFile: () => RuntimeLoader.wasmURL,
+      // Instantiates the Wasm bundle through the persistent cache, if enabled
+      instantiateWasm: PersistentCache.cachesWasm
+        ? PersistentCache.instantiateWasm(RuntimeLoader.wasmURL)
+        : undefined,
     }).then((rive: rc.RiveCanvas) => {
       RuntimeLoader.runtime = rive;
       // Fire all the callbacks
@@ -220,8 +224,290 @@ export class RuntimeLoader {
 
 // #endregion
 
+// #region persistent cache
+
+/**
+ * Opt-in cache that keeps the Wasm runtime and Rive file data in Cache Storage
+ * between visits. Entries are stored per package version, and Rive files are
+ * only cached once they've been imported successfully. Reusing the cached
+ * Wasm response also lets the browser reuse its compiled code, which is most
+ * of the startup cost on low-end devices.
+ */
+export class PersistentCache {
+  private static enabled = false;
+  // Cache Storage is per origin, so name it by package and version; caches
+  // from other versions are deleted when the cache is enabled
+  private static readonly prefix = `rive:${packageData.name}@`;
+  private static readonly cacheName = `${PersistentCache.prefix}${packageData.version}`;
+  // SHA-256 digests of cached Rive files, by src; a cached file is only used
+  // once its digest has been stored, which happens after it has imported
+  private static readonly digestCacheName = `${PersistentCache.cacheName}/digests`;
+
+  // Class is never instantiated
+  private constructor() {}
+
+  /**
+   * Enables the cache. This must be called before the first Rive instance is
+   * created for the Wasm runtime to be cached.
+   */
+  public static enable(): void {
+    if (PersistentCache.enabled || typeof caches === "undefined") {
+      return;
+    }
+    PersistentCache.enabled = true;
+    caches
+      .keys()
+      .then((names) =>
+        Promise.all(
+          names
+            .filter(
+              (name) =>
+                name.indexOf(PersistentCache.prefix) === 0 &&
+                name !== PersistentCache.cacheName &&
+                name !== PersistentCache.digestCacheName
+            )
+            .map((name) => caches.delete(name))
+        )
+      )
+      .catch(() => {});
+  }
+
+  public static get isEnabled(): boolean {
+    return PersistentCache.enabled;
+  }
+
+  // The single-file packages embed the Wasm in the JS, so there's nothing to
+  // fetch or cache
+  public static get cachesWasm(): boolean {
+    return PersistentCache.enabled && !/-single$/.test(packageData.name);
+  }
+
+  // Cached Rive files are checked against their digest when read, so they're
+  // only cached where Web Crypto is available
+  public static get cachesFiles(): boolean {
+    return (
+      PersistentCache.enabled &&
+      typeof crypto !== "undefined" &&
+      !!crypto.subtle
+    );
+  }
+
+  /**
+   * Returns an Emscripten instantiateWasm hook that compiles the runtime from
+   * the cached Wasm response, fetching and caching it first if needed
+   */
+  public static instantiateWasm(url: string) {
+    return (
+      imports: WebAssembly.Imports,
+      receiveInstance: (
+        instance: WebAssembly.Instance,
+        module: WebAssembly.Module
+      ) => void
+    ): Record<string, never> => {
+      PersistentCache.fetch(url)
+        .then((res) => instantiate(res, imports))
+        // Don't let a broken cache stop the runtime from loading, and drop
+        // whatever it holds so later loads don't fail the same way
+        .catch(() => {
+          PersistentCache.delete(url).catch(() => {});
+          return instantiate(fetch(url), imports);
+        })
+        .then(({ instance, module }) => receiveInstance(instance, module))
+        .catch((e) => console.error(e));
+      // Tells Emscripten that instantiation is happening asynchronously
+      return {};
+    };
+  }
+
+  // Returns the cached response for a url, fetching and caching it if missing
+  private static async fetch(url: string): Promise<Response> {
+    const cache = await caches.open(PersistentCache.cacheName);
+    const cached = await cache.match(url);
+    if (cached) {
+      return cached;
+    }
+    const res = await fetch(url);
+    if (res.ok) {
+      await cache.put(url, res.clone());
+    }
+    return res;
+  }
+
+  // Drops the cached response for a url
+  private static async delete(url: string): Promise<void> {
+    const cache = await caches.open(PersistentCache.cacheName);
+    await cache.delete(url);
+  }
+
+  /**
+   * Fetches a Rive file, from the cache if it's there, and only goes to the
+   * network on a miss. A cached copy may be stale; revalidate it with
+   * revalidateFile() once it's in use, which Rive instances do in the
+   * background so that a newer version is picked up on the next load.
+   */
+  public static async fetchFile(
+    src: string
+  ): Promise<{ cached?: CachedFile; response?: Response }> {
+    const cached = await PersistentCache.matchFile(src);
+    if (cached) {
+      return { cached };
+    }
+    return { response: await fetch(new Request(src)) };
+  }
+
+  /**
+   * Returns the cached data for a Rive file and its digest, if there are both
+   */
+  public static async matchFile(src: string): Promise<CachedFile | undefined> {
+    try {
+      const [cache, digests] = await Promise.all([
+        caches.open(PersistentCache.cacheName),
+        caches.open(PersistentCache.digestCacheName),
+      ]);
+      const [response, digest] = await Promise.all([
+        cache.match(src),
+        digests.match(src),
+      ]);
+      if (!response || !digest) {
+        return undefined;
+      }
+      return { response, digest: await digest.text() };
+    } catch {
+      return undefined;
+    }
+  }
+
+  /**
+   * Whether a response for a Rive file can be cached; it has to carry an ETag
+   * or Last-Modified header, so the cached copy can be revalidated later
+   */
+  public static canStore(res: Response): boolean {
+    return (
+      res.ok && (res.headers.has("ETag") || res.headers.has("Last-Modified"))
+    );
+  }
+
+  /**
+   * Caches the response for a Rive file, reading its body as it streams in.
+   * It's not used until its digest is stored with putDigest().
+   */
+  public static async putFile(src: string, res: Response): Promise<void> {
+    const cache = await caches.open(PersistentCache.cacheName);
+    await cache.put(src, res);
+  }
+
+  /**
+   * Stores the digest of a cached Rive file, once it has imported successfully
+   */
+  public static async putDigest(src: string, digest: string): Promise<void> {
+    const digests = await caches.open(PersistentCache.digestCacheName);
+    await digests.put(src, new Response(digest));
+  }
+
+  /**
+   * Drops the cached data for a Rive file, i.e. if it failed to import
+   */
+  public static async deleteFile(src: string): Promise<void> {
+    // The digest goes first, so the data is never used without it
+    const digests = await caches.open(PersistentCache.digestCacheName);
+    await digests.delete(src);
+    const cache = await caches.open(PersistentCache.cacheName);
+    await cache.delete(src);
+  }
+
+  /**
+   * Checks a cached Rive file against the network in the background with a
+   * HEAD request, and only downloads it again if its ETag or Last-Modified
+   * header has changed. The new data replaces the cached copy for next time,
+   * once it has downloaded in full; if it fails to import then, it's dropped
+   * from the cache.
+   */
+  public static async revalidateFile(
+    src: string,
+    cached: Response
+  ): Promise<void> {
+    const head = await fetch(src, { method: "HEAD", cache: "no-store" });
+    if (!head.ok || PersistentCache.isSameVersion(head, cached)) {
+      return;
+    }
+    const res = await fetch(src, { cache: "no-store" });
+    if (!PersistentCache.canStore(res)) {
+      return;
+    }
+    // Reading the body through to its digest fails if the download does, and
+    // leaves the cached copy in place
+    const digest = await res
+      .clone()
+      .arrayBuffer()
+      .then((buffer) => contentHash(new Uint8Array(buffer)));
+    await PersistentCache.putFile(src, res);
+    await PersistentCache.putDigest(src, digest);
+  }
+
+  // Compares ETags if both responses have one, otherwise Last-Modified dates;
+  // a response with neither is taken to be unchanged
+  private static isSameVersion(res: Response, cached: Response): boolean {
+    const etag = res.headers.get("ETag");
+    const cachedEtag = cached.headers.get("ETag");
+    if (etag && cachedEtag) {
+      return etag === cachedEtag;
+    }
+    const lastModified = res.headers.get("Last-Modified");
+    return (
+      !lastModified || lastModified === cached.headers.get("Last-Modified")
+    );
+  }
+}
+
+// A Rive file in the persistent cache
+interface CachedFile {
+  response: Response;
+  // SHA-256 of the file's data, checked when it's read
+  digest: string;
+}
+
+// Instantiates a Wasm module from a response, falling back to a non-streaming
+// compile if the response isn't served as application/wasm
+const instantiate = async (
+  response: Response | Promise<Response>,
+  imports: WebAssembly.Imports
+): Promise<WebAssembly.WebAssemblyInstantiatedSource> => {
+  const res = await response;
+  if (typeof WebAssembly.instantiateStreaming === "function") {
+    try {
+      return await WebAssembly.instantiateStreaming(res.clone(), imports);
+    } catch {
+      // Fall through to the ArrayBuffer path below
+    }
+  }
+  return WebAssembly.instantiate(await res.arrayBuffer(), imports);
+};
+
+// Returns a hex SHA-256 of some bytes, or an empty string where Web Crypto is
+// unavailable (i.e. outside of secure contexts)
+const contentHash = async (bytes: Uint8Array): Promise<string> => {
+  if (typeof crypto === "undefined" || !crypto.subtle) {
+    return "";
+  }
+  const digest = new Uint8Array(await crypto.subtle.digest("SHA-256", bytes));
+  let hex = "";
+  for (let i = 0; i < digest.length; i++) {
+    hex += (digest[i] + 0x100).toString(16).substring(1);
+  }
+  return hex;
+};
+
+// #endregion
+
 // #region animations
 
+// Where an animation or state machine records what happens as it advances;
+// the tag identifies it in the queue's records
+interface EventSink {
+  queue: rc.EventQueue;
+  tag: number;
+}
+
 // Wraps animations and instances from the runtime and keeps track of playback
 // state
 class Animation {
@@ -236,12 +522,15 @@ class Animation {
    * @constructor
    * @param {any} animation: runtime animation object
    * @param {any} instance: runtime animation instance object
+   * @param events where loops are recorded; without one, loopCount is updated
+   * as the animation advances
    */
   constructor(
     private animation: rc.LinearAnimation,
     private artboard: rc.Artboard,
     runtime: rc.RiveCanvas,
-    public playing: boolean
+    public playing: boolean,
+    public readonly events?: EventSink
   ) {
     this.instance = new runtime.LinearAnimationInstance(animation, artboard);
   }
@@ -270,15 +559,29 @@ class Animation {
    * Advances the animation by the give time. If the animation needs scrubbing,
    * time is ignored and the stored scrub value is used.
    * @param time the time to advance the animation by if no scrubbing required
+   * @returns true if the animation will keep changing on later advances
    */
-  public advance(time: number) {
+  public advance(time: number): boolean {
     if (this.scrubTo === null) {
-      this.instance.advance(time);
+      return this.advanceInstance(time);
     } else {
       this.instance.time = 0;
-      this.instance.advance(this.scrubTo);
+      this.advanceInstance(this.scrubTo);
       this.scrubTo = null;
+      return true;
+    }
+  }
+
+  private advanceInstance(time: number): boolean {
+    if (this.events) {
+      const { queue, tag } = this.events;
+      return queue.advanceAnimation(this.instance, tag, time);
+    }
+    const keepGoing = this.instance.advance(time);
+    if (this.instance.didLoop) {
+      this.loopCount += 1;
     }
+    return keepGoing;
   }
 
   /**
@@ -321,7 +624,8 @@ export enum StateMachineInputType {
 export class StateMachineInput {
   constructor(
     public readonly type: StateMachineInputType,
-    private runtimeInput: rc.SMIInput
+    private runtimeInput: rc.SMIInput,
+    private onChange?: VoidCallback
   ) {}
 
   /**
@@ -343,6 +647,7 @@ export class StateMachineInput {
    */
   public set value(value: number | boolean) {
     this.runtimeInput.value = value;
+    this.onChange?.();
   }
 
   /**
@@ -351,10 +656,51 @@ export class StateMachineInput {
   public fire(): void {
     if (this.type === StateMachineInputType.Trigger) {
       this.runtimeInput.fire();
+      this.onChange?.();
     }
   }
 }
 
+/**
+ * Input values for a state machine, one float per input in Wasm memory,
+ * indexed by input handle. Values mean the same as they do for
+ * setStateMachineInputs(). Writes are picked up on the next advance; call
+ * commit() after writing so there is one even if rendering went idle.
+ */
+export class StateMachineInputSlots {
+  constructor(
+    private runtimeSlots: rc.StateMachineInputSlots,
+    private onChange?: VoidCallback
+  ) {}
+
+  /**
+   * Returns a view of the slots to write into. Growing Wasm memory invalidates
+   * old views, so fetch a fresh one before each write.
+   */
+  public values(): Float32Array {
+    return this.runtimeSlots.values();
+  }
+
+  /**
+   * Restarts rendering if it went idle, so that values written since the
+   * last advance are picked up. Call once after a batch of writes.
+   */
+  public commit(): void {
+    this.onChange?.();
+  }
+
+  /**
+   * Passes on what was written to the inputs; returns true if any changed
+   */
+  public apply(): boolean {
+    return this.runtimeSlots.apply();
+  }
+
+  public delete(): void {
+    this.runtimeSlots.delete();
+  }
+}
+
 class StateMachine {
   /**
    * Caches the inputs from the runtime
@@ -366,18 +712,41 @@ class StateMachine {
    */
   public readonly instance: rc.StateMachineInstance;
 
+  /**
+   * Whether the state machine, or one in a nested artboard, has listeners.
+   * Finding out walks the nested artboards, so it's done once up front rather
+   * than every time pointer listeners are set up.
+   */
+  public readonly hasListeners: boolean;
+
+  /**
+   * Handles of the inputs by name; see inputHandle()
+   */
+  private readonly inputHandles = new Map<string, number>();
+
+  /**
+   * Input slots in Wasm memory, created on first use
+   */
+  private slots: StateMachineInputSlots | null = null;
+
   /**
    * @constructor
    * @param stateMachine runtime state machine object
    * @param instance runtime state machine instance object
+   * @param onInputChange called whenever one of the inputs is set or fired
+   * @param events where state changes are recorded as the state machine
+   * advances
    */
   constructor(
     private stateMachine: rc.StateMachine,
-    runtime: rc.RiveCanvas,
+    private runtime: rc.RiveCanvas,
     public playing: boolean,
-    private artboard: rc.Artboard
+    private artboard: rc.Artboard,
+    private onInputChange?: VoidCallback,
+    public readonly events?: EventSink
   ) {
     this.instance = new runtime.StateMachineInstance(stateMachine, artboard);
+    this.hasListeners = runtime.hasListeners(this.instance);
     this.initInputs(runtime);
   }
 
@@ -399,9 +768,52 @@ class StateMachine {
   /**
    * Advances the state machine instance by a given time.
    * @param time - the time to advance the animation by in seconds
+   * @returns true if the state machine will keep changing on later advances
+   */
+  public advance(time: number): boolean {
+    // Pick up anything written to the input slots since the last advance
+    const inputsChanged = this.slots?.apply() ?? false;
+    const keepGoing = this.events
+      ? this.events.queue.advanceStateMachine(
+          this.instance,
+          this.events.tag,
+          time
+        )
+      : this.instance.advance(time);
+    return keepGoing || inputsChanged;
+  }
+
+  /**
+   * Returns a stable handle for the named input, or -1 if there's no such
+   * input. Handles identify inputs in setInputs() and the input slots.
+   * @param name the name of the input
+   */
+  public inputHandle(name: string): number {
+    return this.inputHandles.get(name) ?? -1;
+  }
+
+  /**
+   * Sets many inputs with a single call into the runtime
+   * @param pairs flat pairs of input handle and value; booleans are set to
+   * whether the value is nonzero, and triggers fire if it's nonzero
    */
-  public advance(time: number) {
-    this.instance.advance(time);
+  public setInputs(pairs: Float32Array | number[]): void {
+    this.instance.setInputs(pairs);
+    this.onInputChange?.();
+  }
+
+  /**
+   * Returns the input slots: one float per input, indexed by handle, which
+   * are picked up on the next advance
+   */
+  public get inputSlots(): StateMachineInputSlots {
+    if (!this.slots) {
+      this.slots = new StateMachineInputSlots(
+        new this.runtime.StateMachineInputSlots(this.instance),
+        this.onInputChange
+      );
+    }
+    return this.slots;
   }
 
   /**
@@ -412,6 +824,7 @@ class StateMachine {
     // Fetch the inputs from the runtime if we don't have them
     for (let i = 0; i < this.instance.inputCount(); i++) {
       const input = this.instance.input(i);
+      this.inputHandles.set(input.name, i);
       this.inputs.push(this.mapRuntimeInput(input, runtime));
     }
   }
@@ -427,17 +840,20 @@ class StateMachine {
     if (input.type === runtime.SMIInput.bool) {
       return new StateMachineInput(
         StateMachineInputType.Boolean,
-        input.asBool()
+        input.asBool(),
+        this.onInputChange
       );
     } else if (input.type === runtime.SMIInput.number) {
       return new StateMachineInput(
         StateMachineInputType.Number,
-        input.asNumber()
+        input.asNumber(),
+        this.onInputChange
       );
     } else if (input.type === runtime.SMIInput.trigger) {
       return new StateMachineInput(
         StateMachineInputType.Trigger,
-        input.asTrigger()
+        input.asTrigger(),
+        this.onInputChange
       );
     }
   }
@@ -447,6 +863,8 @@ class StateMachine {
    * state machine is no more.
    */
   public cleanup() {
+    this.slots?.delete();
+    this.slots = null;
     this.instance.delete();
   }
 }
@@ -459,11 +877,33 @@ class StateMachine {
  * Manages animation
  */
 class Animator {
+  /**
+   * Records state changes and loops as animations and state machines advance
+   */
+  private events: rc.EventQueue;
+
+  /**
+   * Names from the event queue's name table, by id
+   */
+  private readonly eventNames: string[] = [];
+
+  /**
+   * Tag for the next animation or state machine to be instanced
+   */
+  private nextEventTag = 0;
+
+  /**
+   * Instanced animations and state machines by the tag they record events
+   * under
+   */
+  private readonly eventSources = new Map<number, Animation | StateMachine>();
+
   /**
    * Constructs a new animator
    * @constructor
    * @param runtime Rive runtime; needed to instance animations & state machines
    * @param artboard the artboard that holds all animations and state machines
+   * @param onInputChange called whenever a state machine input is set or fired
    * @param animations optional list of animations
    * @param stateMachines optional list of state machines
    */
@@ -471,9 +911,12 @@ class Animator {
     private runtime: rc.RiveCanvas,
     private artboard: rc.Artboard,
     private eventManager: EventManager,
+    private onInputChange?: VoidCallback,
     public readonly animations: Animation[] = [],
     public readonly stateMachines: StateMachine[] = []
-  ) {}
+  ) {
+    this.events = new runtime.EventQueue();
+  }
 
   /**
    * Adds animations and state machines by their names. If names are shared
@@ -511,12 +954,15 @@ class Animator {
           // Try to create a new animation instance
           const anim = this.artboard.animationByName(animatables[i]);
           if (anim) {
+            const tag = this.nextEventTag++;
             const newAnimation = new Animation(
               anim,
               this.artboard,
               this.runtime,
-              playing
+              playing,
+              { queue: this.events, tag }
             );
+            this.eventSources.set(tag, newAnimation);
             // Display the first frame of the specified animation
             newAnimation.advance(0);
             newAnimation.apply(1.0);
@@ -525,12 +971,16 @@ class Animator {
             // Try to create a new state machine instance
             const sm = this.artboard.stateMachineByName(animatables[i]);
             if (sm) {
+              const tag = this.nextEventTag++;
               const newStateMachine = new StateMachine(
                 sm,
                 this.runtime,
                 playing,
-                this.artboard
+                this.artboard,
+                this.onInputChange,
+                { queue: this.events, tag }
               );
+              this.eventSources.set(tag, newStateMachine);
               this.stateMachines.push(newStateMachine);
             }
           }
@@ -631,6 +1081,7 @@ class Animator {
       // Empty out the arrays
       this.animations.splice(0, this.animations.length);
       this.stateMachines.splice(0, this.stateMachines.length);
+      this.eventSources.clear();
     } else {
       // Remove only the named animations/state machines
       const animationsToRemove = this.animations.filter((a) =>
@@ -640,6 +1091,7 @@ class Animator {
       animationsToRemove.forEach((a) => {
         a.cleanup();
         this.animations.splice(this.animations.indexOf(a), 1);
+        this.eventSources.delete(a.events.tag);
       });
       const machinesToRemove = this.stateMachines.filter((m) =>
         animatables.includes(m.name)
@@ -647,6 +1099,7 @@ class Animator {
       machinesToRemove.forEach((m) => {
         m.cleanup();
         this.stateMachines.splice(this.stateMachines.indexOf(m), 1);
+        this.eventSources.delete(m.events.tag);
       });
       removedNames = animationsToRemove
         .map((a) => a.name)
@@ -746,14 +1199,36 @@ class Animator {
   }
 
   /**
-   * Checks if states have changed in state machines and fires a statechange
-   * event
+   * Reads everything recorded in the event queue since the last call, then
+   * fires loop and statechange events
    */
-  public handleStateChanges() {
+  public handleEvents() {
     const statesChanged: string[] = [];
-    for (const stateMachine of this.stateMachines.filter((sm) => sm.playing)) {
-      statesChanged.push(...stateMachine.statesChanged);
+    const { EventQueue } = this.runtime;
+    for (
+      let records = this.events.drain();
+      records.length > 0;
+      records = this.events.drain()
+    ) {
+      for (let i = 0; i < records.length; i += 4) {
+        const source = this.eventSources.get(records[i + 1]);
+        if (records[i] === EventQueue.loop) {
+          if (source instanceof Animation) {
+            source.loopCount += 1;
+          }
+        } else if (records[i] === EventQueue.stateChange) {
+          if (source instanceof StateMachine) {
+            statesChanged.push(this.eventName(records[i + 2]));
+          }
+        } else if (records[i] === EventQueue.overflow) {
+          console.warn(
+            `${records[i + 3]} loop and state change events were dropped`
+          );
+        }
+      }
     }
+
+    this.handleLooping();
     if (statesChanged.length > 0) {
       this.eventManager.fire({
         type: EventType.StateChange,
@@ -761,6 +1236,25 @@ class Animator {
       });
     }
   }
+
+  /**
+   * Returns the event queue's name with the given id, fetching any names added
+   * since the last lookup
+   */
+  private eventName(id: number): string {
+    for (let i = this.eventNames.length; i <= id; i++) {
+      this.eventNames.push(this.events.name(i));
+    }
+    return this.eventNames[id];
+  }
+
+  /**
+   * Deletes the event queue; the animator can't be used afterwards
+   */
+  public cleanup() {
+    this.events?.delete();
+    this.events = null;
+  }
 }
 
 // #endregion
@@ -1043,6 +1537,10 @@ export class Rive {
   // Runtime file
   private file: rc.File;
 
+  // Registry entry for the runtime file, which may be shared with other
+  // instances loading the same data
+  private sharedFile: SharedFile | null = null;
+
   // Holds event listeners
   private eventManager: EventManager;
 
@@ -1146,7 +1644,15 @@ export class Rive {
     this.readyForPlaying = false;
 
     // Ensure the runtime is loaded
-    RuntimeLoader.awaitInstance()
+    const runtimeReady = RuntimeLoader.awaitInstance();
+
+    // Start fetching the Rive data alongside the runtime load rather than
+    // after it, so the download and the Wasm compile overlap. If another
+    // instance has already loaded the same data, its file is shared instead.
+    this.sharedFile = FileRegistry.acquire(runtimeReady, this.src, this.buffer);
+    const fileReady = this.sharedFile.file;
+
+    runtimeReady
       .then((runtime) => {
         this.runtime = runtime;
 
@@ -1164,6 +1670,7 @@ export class Rive {
 
         // Load Rive data from a source uri or a data buffer
         this.initData(
+          fileReady,
           artboard,
           startingAnimationNames,
           startingStateMachineNames,
@@ -1182,7 +1689,7 @@ export class Rive {
   private setupRiveListeners(): void {
     if (!this.shouldDisableRiveListeners) {
       const activeStateMachines = (this.animator.stateMachines || [])
-        .filter((sm) => sm.playing && this.runtime.hasListeners(sm.instance))
+        .filter((sm) => sm.playing && sm.hasListeners)
         .map((sm) => sm.instance);
       this.eventCleanup = registerTouchInteractions({
         canvas: this.canvas,
@@ -1192,23 +1699,26 @@ export class Rive {
         rive: this.runtime,
         fit: this._layout.runtimeFit(this.runtime),
         alignment: this._layout.runtimeAlignment(this.runtime),
+        onInteraction: () => this.wake(),
       });
     }
   }
 
   // Initializes runtime with Rive data and preps for playing
   private async initData(
+    fileReady: Promise<rc.File>,
     artboardName: string,
     animationNames: string[],
     stateMachineNames: string[],
     autoplay: boolean
   ): Promise<void> {
-    // Load the buffer from the src if provided
-    if (this.src) {
-      this.buffer = await loadRiveFile(this.src);
+    // Wait for the Rive file; it's been on its way since init() was called
+    const file = await fileReady;
+    // A later load() may have released this file while it was on its way
+    if (fileReady !== this.sharedFile?.file) {
+      return;
     }
-    // Load the Rive file
-    this.file = await this.runtime.load(new Uint8Array(this.buffer));
+    this.file = file;
 
     if (this.file) {
       // Initialize and draw frame
@@ -1275,7 +1785,8 @@ export class Rive {
     this.animator = new Animator(
       this.runtime,
       this.artboard,
-      this.eventManager
+      this.eventManager,
+      () => this.wake()
     );
 
     // Initialize the animations; as loaded hasn't happened yet, we need to
@@ -1310,6 +1821,10 @@ export class Rive {
   // Tracks the current animation frame request
   private frameRequestId: number | null;
 
+  // True when the render loop stopped itself because nothing on the artboard
+  // was changing. It restarts when something might change it again.
+  private idle = false;
+
   /**
    * Used be draw to track when a second of active rendering time has passed.
    * Used for debugging purposes
@@ -1350,11 +1865,11 @@ export class Rive {
       // The scrubbed animations must be applied first to prevent weird artifacts
       // if the playing animations conflict with the scrubbed animating attribuates.
       .sort((first) => (first.needsScrub ? -1 : 1));
+    // Track whether anything will keep changing, so rendering can stop once
+    // everything has settled.
+    let needsAdvance = false;
     for (const animation of activeAnimations) {
-      animation.advance(elapsedTime);
-      if (animation.instance.didLoop) {
-        animation.loopCount += 1;
-      }
+      needsAdvance = animation.advance(elapsedTime) || needsAdvance;
       animation.apply(1.0);
     }
 
@@ -1364,13 +1879,13 @@ export class Rive {
       (a) => a.playing
     );
     for (const stateMachine of activeStateMachines) {
-      stateMachine.advance(elapsedTime);
+      needsAdvance = stateMachine.advance(elapsedTime) || needsAdvance;
       // stateMachine.instance.apply(this.artboard);
     }
 
     // Once the animations have been applied to the artboard, advance it
     // by the elapsed time.
-    this.artboard.advance(elapsedTime);
+    needsAdvance = this.artboard.advance(elapsedTime) || needsAdvance;
 
     const { renderer } = this;
     // Canvas must be wiped to prevent artifacts
@@ -1385,11 +1900,9 @@ export class Rive {
     renderer.restore();
     renderer.flush();
 
-    // Check for any animations that looped
-    this.animator.handleLooping();
-
-    // Check for any state machines that had a state change
-    this.animator.handleStateChanges();
+    // Fire events for any animations that looped and any state machines that
+    // had a state change
+    this.animator.handleEvents();
 
     // Add duration to create frame to durations array
     this.frameCount++;
@@ -1403,9 +1916,14 @@ export class Rive {
 
     // Calling requestAnimationFrame will rerun draw() at the correct rate:
     // https://developer.mozilla.org/en-US/docs/Web/API/Canvas_API/Tutorial/Basic_animations
-    if (this.animator.isPlaying) {
+    if (this.animator.isPlaying && needsAdvance) {
       // Request a new rendering frame
       this.startRendering();
+    } else if (this.animator.isPlaying) {
+      // Everything has settled, so this frame would be drawn over and over.
+      // Stop until an input, pointer event, resize or API call wakes us up.
+      this.idle = true;
+      this.lastRenderTime = 0;
     } else if (this.animator.isPaused) {
       // Reset the end time so on playback it starts at the correct frame
       this.lastRenderTime = 0;
@@ -1466,8 +1984,15 @@ export class Rive {
     // Delete the renderer
     this.renderer?.delete();
     this.renderer = null;
-    // Delete the rive file
-    this.file?.delete();
+    this.releaseFile();
+  }
+
+  // Releases the rive file; it's deleted once no other instances use it
+  private releaseFile(): void {
+    if (this.sharedFile) {
+      FileRegistry.release(this.sharedFile);
+      this.sharedFile = null;
+    }
     this.file = null;
   }
 
@@ -1484,6 +2009,7 @@ export class Rive {
     }
     // Delete all animation and state machine instances
     this.stop();
+    this.animator?.cleanup();
     if (this.artboard) {
       this.artboard.delete();
       this.artboard = null;
@@ -1586,8 +2112,11 @@ export class Rive {
 
   // Loads a new Rive file, keeping listeners in place
   public load(params: RiveLoadParameters): void {
-    // Stop all animations
-    this.stop();
+    // Stop all animations and delete what was instanced from the current file,
+    // then let go of the file; it's deleted once no other instances use it
+    this.stopRendering();
+    this.cleanupInstances();
+    this.releaseFile();
     // Reinitialize
     this.init(params);
   }
@@ -1595,11 +2124,19 @@ export class Rive {
   // Sets a new layout
   public set layout(layout: Layout) {
     this._layout = layout;
+    this.invalidateCanvas();
     // If the maxX or maxY are 0, then set them to the canvas width and height
     if (!layout.maxX || !layout.maxY) {
       this.resizeToCanvas();
     }
-    if (this.loaded && !this.animator.isPlaying) {
+    // The listeners map pointer positions with the layout's fit and alignment
+    if (this.loaded) {
+      if (this.eventCleanup) {
+        this.eventCleanup();
+      }
+      this.setupRiveListeners();
+    }
+    if (this.loaded && (!this.animator.isPlaying || this.idle)) {
       this.drawFrame();
     }
   }
@@ -1624,6 +2161,7 @@ export class Rive {
       maxX: this.canvas.width,
       maxY: this.canvas.height,
     });
+    this.invalidateCanvas();
   }
 
   /**
@@ -1636,13 +2174,31 @@ export class Rive {
     if (this.canvas instanceof HTMLCanvasElement && !!window) {
       const { width, height } = this.canvas.getBoundingClientRect();
       const dpr = window.devicePixelRatio || 1;
-      this.canvas.width = dpr * width;
-      this.canvas.height = dpr * height;
+      // Assigning the size wipes the canvas even when it doesn't change it,
+      // and the canvas renderer only redraws the parts of a frame that changed.
+      // The canvas truncates its size to an integer.
+      const newWidth = Math.floor(dpr * width);
+      const newHeight = Math.floor(dpr * height);
+      if (this.canvas.width !== newWidth) {
+        this.canvas.width = newWidth;
+      }
+      if (this.canvas.height !== newHeight) {
+        this.canvas.height = newHeight;
+      }
       this.startRendering();
       this.resizeToCanvas();
     }
   }
 
+  /**
+   * Has the next frame redraw the whole canvas. The canvas renderer otherwise
+   * only redraws the parts of a frame that changed, which relies on the canvas
+   * still holding the previous frame.
+   */
+  private invalidateCanvas() {
+    (this.renderer as rc.CanvasRenderer)?.invalidate?.();
+  }
+
   // Returns the animation source, which may be undefined
   public get source(): string {
     return this.src;
@@ -1700,6 +2256,67 @@ export class Rive {
     return stateMachine?.inputs;
   }
 
+  /**
+   * Returns a stable handle for an input of an instanced state machine, for
+   * use with setStateMachineInputs() and stateMachineInputSlots(). Returns -1
+   * if there's no such state machine or input.
+   * @param stateMachineName the state machine name
+   * @param inputName the input name
+   */
+  public stateMachineInputHandle(
+    stateMachineName: string,
+    inputName: string
+  ): number {
+    if (!this.loaded) {
+      return -1;
+    }
+    const stateMachine = this.animator.stateMachines.find(
+      (m) => m.name === stateMachineName
+    );
+    return stateMachine ? stateMachine.inputHandle(inputName) : -1;
+  }
+
+  /**
+   * Sets many inputs of an instanced state machine in a single call
+   * @param stateMachineName the state machine name
+   * @param pairs flat pairs of input handle and value: numbers take the value,
+   * booleans are set to whether it's nonzero, and triggers fire if it's
+   * nonzero
+   */
+  public setStateMachineInputs(
+    stateMachineName: string,
+    pairs: Float32Array | number[]
+  ): void {
+    if (!this.loaded) {
+      return;
+    }
+    const stateMachine = this.animator.stateMachines.find(
+      (m) => m.name === stateMachineName
+    );
+    stateMachine?.setInputs(pairs);
+  }
+
+  /**
+   * Returns input slots for an instanced state machine: one float per input
+   * in Wasm memory, indexed by handle, with the same meaning as the values
+   * passed to setStateMachineInputs(). Writes are picked up on the next
+   * advance; follow them with `commit()`, which restarts rendering if it
+   * went idle. Fetch a fresh `values()` view before each write, since
+   * growing Wasm memory invalidates old views.
+   * @param stateMachineName the state machine name
+   */
+  public stateMachineInputSlots(
+    stateMachineName: string
+  ): StateMachineInputSlots | undefined {
+    if (!this.loaded) {
+      return;
+    }
+    const stateMachine = this.animator.stateMachines.find(
+      (m) => m.name === stateMachineName
+    );
+    return stateMachine?.inputSlots;
+  }
+
   // Returns a list of playing machine names
   public get playingStateMachineNames(): string[] {
     // If the file's not loaded, we got nothing to return
@@ -1817,6 +2434,7 @@ export class Rive {
    * they would have been at if rendering had not been stopped.
    */
   public stopRendering() {
+    this.idle = false;
     if (this.loaded && this.frameRequestId) {
       if (this.runtime.cancelAnimationFrame) {
         this.runtime.cancelAnimationFrame(this.frameRequestId);
@@ -1832,6 +2450,7 @@ export class Rive {
    * renderer is already active, then this will have zero effect.
    */
   public startRendering() {
+    this.idle = false;
     if (this.loaded && this.artboard && !this.frameRequestId) {
       if (this.runtime.requestAnimationFrame) {
         this.frameRequestId = this.runtime.requestAnimationFrame(
@@ -1843,6 +2462,17 @@ export class Rive {
     }
   }
 
+  /**
+   * Restarts the rendering loop if it stopped itself because nothing was
+   * changing; does nothing if it's running or was stopped with
+   * `stopRendering`.
+   */
+  private wake() {
+    if (this.idle) {
+      this.startRendering();
+    }
+  }
+
   /**
    * Enables frames-per-second (FPS) reporting for the runtime
    * If no callback is provided, Rive will append a fixed-position div at the top-right corner of
@@ -1937,16 +2567,386 @@ interface RiveFileContents {
   artboards?: ArtboardContents[];
 }
 
-// Loads Rive data from a URI via fetch.
-const loadRiveFile = async (src: string): Promise<ArrayBuffer> => {
-  const req = new Request(src);
-  const res = await fetch(req);
-  const buffer = await res.arrayBuffer();
-  return buffer;
+// Streams Rive data from a URI via fetch (or from an already available
+// response) into a buffer in the Wasm heap, copying each chunk across as soon
+// as it arrives rather than waiting for the whole download to land in an
+// intermediate ArrayBuffer. The fetch doesn't wait for the runtime; chunks
+// that arrive before it's ready are held in JS and handed over once it is.
+// Parsing still waits for the whole file; see loadFromBuffer() in bindings.cpp.
+const streamRiveFile = async (
+  runtimeReady: Promise<rc.RiveCanvas>,
+  source: string | Response
+): Promise<rc.FileBuffer> => {
+  const res =
+    typeof source === "string" ? await fetch(new Request(source)) : source;
+  if (!res.body) {
+    const [runtime, buffer] = await Promise.all([
+      runtimeReady,
+      res.arrayBuffer(),
+    ]);
+    return copyToFileBuffer(runtime, buffer);
+  }
+
+  // Content-Length is only a hint; it's the encoded size if the response is
+  // compressed, in which case the buffer will grow as needed.
+  const contentLength = Number(res.headers.get("Content-Length"));
+  const pendingChunks: Uint8Array[] = [];
+  let fileBuffer: rc.FileBuffer = null;
+  const bufferReady = runtimeReady.then((runtime) => {
+    fileBuffer = new runtime.FileBuffer(0);
+    if (contentLength > 0) {
+      fileBuffer.reserve(contentLength);
+    }
+    for (const chunk of pendingChunks) {
+      fileBuffer.append(chunk);
+    }
+    pendingChunks.length = 0;
+  });
+
+  const reader = res.body.getReader();
+  try {
+    for (;;) {
+      const { done, value } = await reader.read();
+      if (done) {
+        break;
+      }
+      if (fileBuffer) {
+        fileBuffer.append(value);
+      } else {
+        pendingChunks.push(value);
+      }
+    }
+    await bufferReady;
+  } catch (e) {
+    // The buffer may not exist yet if the runtime is still loading
+    bufferReady.then(
+      () => fileBuffer.delete(),
+      () => {}
+    );
+    throw e;
+  }
+  return fileBuffer;
+};
+
+// Copies Rive data into a new buffer in the Wasm heap
+const copyToFileBuffer = (
+  runtime: rc.RiveCanvas,
+  buffer: ArrayBuffer
+): rc.FileBuffer => {
+  const fileBuffer = new runtime.FileBuffer(buffer.byteLength);
+  fileBuffer.bytes().set(new Uint8Array(buffer));
+  return fileBuffer;
+};
+
+// Imports Rive data from a buffer in the Wasm heap, which is freed as soon as
+// the file has been imported. If asked to, also takes the SHA-256 of the data
+// once the import is under way, so the digest doesn't hold the import up.
+const importFileBuffer = (
+  runtime: rc.RiveCanvas,
+  fileBuffer: rc.FileBuffer,
+  withDigest = false
+): { file: Promise<rc.File>; digest: Promise<string> } => {
+  // The import itself runs before loadFromBuffer() returns; the promise
+  // resolves once the file's images have decoded
+  const file = runtime.loadFromBuffer(fileBuffer, withDigest);
+  // Web Crypto copies the bytes before contentHash() returns
+  const digest = withDigest
+    ? contentHash(fileBuffer.bytes())
+    : Promise.resolve("");
+  fileBuffer.delete();
+  return { file, digest };
 };
 
 // #endregion
 
+// #region file registry
+
+// A Rive file shared between all Rive instances that load the same data
+interface SharedFile {
+  file: Promise<rc.File>;
+  refCount: number;
+  // Registry keys that resolve to this file
+  keys: string[];
+  // Set when this turned out to be a duplicate of a file that was already
+  // loaded; references are forwarded there
+  alias?: SharedFile;
+}
+
+// A Rive file's data in the Wasm heap, ready to import
+interface FetchedFile {
+  fileBuffer: rc.FileBuffer;
+  // SHA-256 of the data, if it has been taken; empty where Web Crypto is
+  // unavailable
+  digest?: string;
+  // The persistent cache entry the data was read from
+  cached?: Response;
+  // Resolves once freshly downloaded data has been written to the persistent
+  // cache
+  caching?: Promise<void>;
+}
+
+// Refcounted registry of imported Rive files, keyed both by src url and by a
+// SHA-256 digest of the file contents. Rive instances that load the same data
+// share one fetch and one import (and so one copy of any decoded images), and
+// only create their own artboard instances.
+class FileRegistry {
+  private static files = new Map<string, SharedFile>();
+  // Files that are loading or loaded and still in use, whether or not they're
+  // registered under any key yet
+  private static live = new Set<SharedFile>();
+
+  // Class is never instantiated
+  private constructor() {}
+
+  /**
+   * Returns the shared file for a src url or data buffer, loading it if no
+   * other instance has done so already. Must be balanced with a call to
+   * release() once the instance is done with the file.
+   * @param runtimeReady resolves with the runtime once it's loaded
+   * @param src url of the Rive file; takes precedence over buffer
+   * @param buffer Rive file data
+   */
+  public static acquire(
+    runtimeReady: Promise<rc.RiveCanvas>,
+    src?: string,
+    buffer?: ArrayBuffer
+  ): SharedFile {
+    const srcKey = src ? `src:${src}` : null;
+    const existing = srcKey && FileRegistry.files.get(srcKey);
+    if (existing) {
+      existing.refCount++;
+      return existing;
+    }
+
+    const shared: SharedFile = { file: null, refCount: 1, keys: [] };
+    FileRegistry.live.add(shared);
+    if (srcKey) {
+      FileRegistry.register(srcKey, shared);
+    }
+    shared.file = FileRegistry.load(shared, runtimeReady, src, buffer);
+    // Don't hang on to files that failed to load, so they can be retried
+    shared.file.then(
+      (file) => {
+        if (!file) {
+          FileRegistry.unregister(shared);
+        }
+      },
+      () => FileRegistry.unregister(shared)
+    );
+    return shared;
+  }
+
+  // Fetches (or copies) and imports the data for a newly registered file
+  private static async load(
+    shared: SharedFile,
+    runtimeReady: Promise<rc.RiveCanvas>,
+    src?: string,
+    buffer?: ArrayBuffer
+  ): Promise<rc.File> {
+    const [runtime, fetched] = await Promise.all([
+      runtimeReady,
+      src
+        ? FileRegistry.fetchFile(runtimeReady, src)
+        : runtimeReady.then(
+            (runtime): FetchedFile => ({
+              fileBuffer: copyToFileBuffer(runtime, buffer),
+            })
+          ),
+    ]);
+    const { fileBuffer } = fetched;
+    // Every instance let go of the file while it was being fetched, and
+    // release() has already unregistered it
+    if (shared.refCount === 0) {
+      fileBuffer.delete();
+      return null;
+    }
+
+    // Different sources may still hold identical data. Files are only shared
+    // on a match of a strong digest, as a collision would hand an instance the
+    // wrong file; without Web Crypto, they're only shared by src. Data read
+    // back from the persistent cache already has its digest, so a duplicate
+    // isn't imported at all.
+    if (fetched.digest) {
+      const original = FileRegistry.files.get(`sha256:${fetched.digest}`);
+      if (original) {
+        fileBuffer.delete();
+        return FileRegistry.alias(shared, original, src, fetched);
+      }
+    }
+    // Otherwise the digest is only taken where it's used: to store a download
+    // in the persistent cache, or to spot a duplicate while other files are in
+    // use. A file loaded on its own is never hashed, so it can't be shared
+    // with an identical one from another source that's loaded later.
+    const imported = importFileBuffer(
+      runtime,
+      fileBuffer,
+      fetched.digest === undefined &&
+        (!!fetched.caching || FileRegistry.live.size > 1)
+    );
+    // Nothing waits on the file until the digest is in
+    imported.file.catch(() => {});
+    if (fetched.digest === undefined) {
+      fetched.digest = await imported.digest;
+    }
+
+    const hashKey = fetched.digest ? `sha256:${fetched.digest}` : null;
+    const original = hashKey && FileRegistry.files.get(hashKey);
+    if (original && shared.refCount > 0) {
+      // The original finished first; this copy is dropped once it's loaded
+      imported.file.then(
+        (file) => file?.delete(),
+        () => {}
+      );
+      return FileRegistry.alias(shared, original, src, fetched);
+    }
+    if (hashKey) {
+      FileRegistry.register(hashKey, shared);
+    }
+
+    let file: rc.File = null;
+    try {
+      file = await imported.file;
+      return file;
+    } finally {
+      FileRegistry.updateCache(src, fetched, !!file);
+    }
+  }
+
+  // Hands a file over to an original with identical data, and returns the
+  // original's file
+  private static alias(
+    shared: SharedFile,
+    original: SharedFile,
+    src: string,
+    fetched: FetchedFile
+  ): Promise<rc.File> {
+    FileRegistry.forward(shared, original);
+    original.file.then(
+      (file) => FileRegistry.updateCache(src, fetched, !!file),
+      () => FileRegistry.updateCache(src, fetched, false)
+    );
+    return original.file;
+  }
+
+  // Streams a Rive file into the Wasm heap, from the persistent cache if it's
+  // enabled and holds a copy that matches its digest
+  private static async fetchFile(
+    runtimeReady: Promise<rc.RiveCanvas>,
+    src: string
+  ): Promise<FetchedFile> {
+    if (!PersistentCache.cachesFiles) {
+      return { fileBuffer: await streamRiveFile(runtimeReady, src) };
+    }
+    const { cached, response } = await PersistentCache.fetchFile(src);
+    if (cached) {
+      const fetched = await FileRegistry.digest(
+        await streamRiveFile(runtimeReady, cached.response)
+      );
+      if (fetched.digest === cached.digest) {
+        fetched.cached = cached.response;
+        return fetched;
+      }
+      // The cached copy is damaged; drop it and go to the network instead
+      fetched.fileBuffer.delete();
+      PersistentCache.deleteFile(src).catch(() => {});
+      return { fileBuffer: await streamRiveFile(runtimeReady, src) };
+    }
+    // Write the download to the cache as it streams in, rather than holding
+    // on to a copy until it's known to import
+    const caching = PersistentCache.canStore(response)
+      ? PersistentCache.putFile(src, response.clone())
+      : undefined;
+    return {
+      fileBuffer: await streamRiveFile(runtimeReady, response),
+      caching,
+    };
+  }
+
+  private static async digest(fileBuffer: rc.FileBuffer): Promise<FetchedFile> {
+    return { fileBuffer, digest: await contentHash(fileBuffer.bytes()) };
+  }
+
+  // Keeps the persistent cache in step with how an import went: cached data
+  // is revalidated if it imported and dropped if it didn't, and a download
+  // being cached only gets its digest stored (and so gets used) if it imported
+  private static updateCache(
+    src: string,
+    { digest, cached, caching }: FetchedFile,
+    imported: boolean
+  ): void {
+    let update: Promise<void> = null;
+    if (cached) {
+      update = imported
+        ? PersistentCache.revalidateFile(src, cached)
+        : PersistentCache.deleteFile(src);
+    } else if (caching) {
+      update = caching.then(() =>
+        imported
+          ? PersistentCache.putDigest(src, digest)
+          : PersistentCache.deleteFile(src)
+      );
+    }
+    update?.catch(() => {});
+  }
+
+  /**
+   * Drops a reference to a shared file, deleting it once it has no users
+   */
+  public static release(shared: SharedFile): void {
+    if (shared.alias) {
+      FileRegistry.release(shared.alias);
+      return;
+    }
+    if (--shared.refCount > 0) {
+      return;
+    }
+    FileRegistry.unregister(shared);
+    shared.file.then(
+      (file) => {
+        // If the file turned out to be a duplicate, the references (and the
+        // file) now belong to the original
+        if (!shared.alias) {
+          file?.delete();
+        }
+      },
+      () => {}
+    );
+  }
+
+  private static register(key: string, shared: SharedFile): void {
+    // A released file is being deleted, so it mustn't be found again
+    if (shared.refCount === 0) {
+      return;
+    }
+    FileRegistry.files.set(key, shared);
+    shared.keys.push(key);
+  }
+
+  private static unregister(shared: SharedFile): void {
+    FileRegistry.live.delete(shared);
+    for (const key of shared.keys) {
+      if (FileRegistry.files.get(key) === shared) {
+        FileRegistry.files.delete(key);
+      }
+    }
+    shared.keys = [];
+  }
+
+  // Hands the references and keys of a duplicate over to the original file
+  private static forward(duplicate: SharedFile, original: SharedFile): void {
+    const keys = duplicate.keys;
+    FileRegistry.unregister(duplicate);
+    for (const key of keys) {
+      FileRegistry.register(key, original);
+    }
+    original.refCount += duplicate.refCount;
+    duplicate.refCount = 0;
+    duplicate.alias = original;
+  }
+}
+
+// #endregion
+
 // #region utility functions
 
 /*
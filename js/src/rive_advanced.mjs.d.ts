@@ -1,5 +1,17 @@
 interface RiveOptions {
   locateFile(file: string): string;
+  /**
+   * Optional Emscripten hook to take over compiling and instantiating the WASM, i.e. from a
+   * cache. Returns an empty object when instantiation completes asynchronously through
+   * `receiveInstance`.
+   */
+  instantiateWasm?(
+    imports: WebAssembly.Imports,
+    receiveInstance: (
+      instance: WebAssembly.Instance,
+      module: WebAssembly.Module
+    ) => void
+  ): Record<string, never>;
 }
 
 declare function Rive(options?: RiveOptions): Promise<RiveCanvas>;
@@ -16,10 +28,20 @@ export interface RiveCanvas {
   CanvasRenderer: typeof CanvasRenderer;
   LinearAnimationInstance: typeof LinearAnimationInstance;
   StateMachineInstance: typeof StateMachineInstance;
+  StateMachineInputSlots: typeof StateMachineInputSlots;
+  ListenerBounds: typeof ListenerBounds;
+  EventQueue: typeof EventQueue;
+  ComponentIndex: typeof ComponentIndex;
+  TransformBatch: typeof TransformBatch;
+  /**
+   * Only in runtimes built with ENABLE_QUERY_FLAT_VERTICES
+   */
+  FlattenedPathBuffer?: typeof FlattenedPathBuffer;
   Mat2D: typeof Mat2D;
   Vec2D: typeof Vec2D;
   AABB: AABB;
   SMIInput: typeof SMIInput;
+  FileBuffer: typeof FileBuffer;
   renderFactory: CanvasRenderFactory;
 
   BlendMode: typeof BlendMode;
@@ -37,6 +59,18 @@ export interface RiveCanvas {
    */
   load(buffer: Uint8Array): Promise<File>;
 
+  /**
+   * Loads a Rive file directly out of a FileBuffer in the WASM heap, without making another copy
+   * of its bytes. The whole file has to be in the buffer, and it's imported in a single blocking
+   * call; only filling the buffer can overlap with the download.
+   *
+   * @param buffer - FileBuffer that has been filled with the bytes of a Rive file
+   * @param retain - Keep the buffer's bytes after importing, e.g. to import them again later.
+   * Defaults to false, which frees the bytes as soon as the file has been imported
+   * @returns A Promise for a Rive File class
+   */
+  loadFromBuffer(buffer: FileBuffer, retain?: boolean): Promise<File>;
+
   /**
    * Creates the renderer to draw the Rive on the provided canvas element
    *
@@ -75,6 +109,16 @@ export interface RiveCanvas {
    * @returns number - An ID of the requestAnimationFrame request
    */
   requestAnimationFrame(cb: (timestamp: DOMHighResTimeStamp) => void): number;
+  /**
+   * Like requestAnimationFrame, except the callback is invoked before every
+   * callback requested with requestAnimationFrame in the same frame; used to
+   * deliver coalesced input ahead of the frame that responds to it.
+   * @param cb - Callback to run at the start of the next frame
+   * @returns number - An ID that can be passed to cancelAnimationFrame
+   */
+  requestPreAnimationFrame(
+    cb: (timestamp: DOMHighResTimeStamp) => void
+  ): number;
   /**
    * A Rive-specific cancelAnimationFrame function; this must be used instead of the global
    * cancelAnimationFrame function.
@@ -169,9 +213,24 @@ export declare class RenderPaintWrapper {
   cap(value: StrokeCap): void;
   blendMode(value: BlendMode): void;
   style(value: RenderPaintStyle): void;
-  linearGradient(sx: number, sy: number, ex: number, ey: number): void;
-  radialGradient(sx: number, sy: number, ex: number, ey: number): void;
-  addStop(color: number, stop: number): void;
+  linearGradient(
+    key: number,
+    sx: number,
+    sy: number,
+    ex: number,
+    ey: number,
+    colors: Uint32Array,
+    stops: Float32Array
+  ): void;
+  radialGradient(
+    key: number,
+    sx: number,
+    sy: number,
+    ex: number,
+    ey: number,
+    colors: Uint32Array,
+    stops: Float32Array
+  ): void;
   completeGradient(): void;
 }
 
@@ -202,6 +261,34 @@ export declare class CanvasRenderer extends Renderer {
   constructor(
     ctx: CanvasRenderingContext2D | OffscreenCanvasRenderingContext2D
   );
+  /**
+   * Number of paths, images and meshes drawn since the last clear()
+   */
+  drawCount(): number;
+  /**
+   * Number of draws since the last clear() that were skipped because they
+   * were entirely outside of the canvas or the current clip
+   */
+  culledDrawCount(): number;
+  /**
+   * Number of paths whose geometry was sent to the canvas since the last
+   * clear(). Paths drawn again unchanged, or rebuilt with the same geometry,
+   * reuse what was sent before and aren't counted.
+   */
+  pathSyncCount(): number;
+  /**
+   * Caps the resolution image meshes are rasterized at, relative to their
+   * texture's resolution. Lower values trade sharpness for fill cost. Defaults
+   * to 1.
+   */
+  meshQuality: number;
+  /**
+   * Redraws the whole canvas on the next frame, rather than only the parts
+   * that changed. Call this after anything else draws to the canvas. Resizing
+   * or resetting the canvas, e.g. by assigning its width or height, is
+   * detected on the next frame.
+   */
+  invalidate(): void;
 }
 
 export declare class CanvasRenderPaint extends RenderPaint {
@@ -249,6 +336,47 @@ export declare class File {
   delete(): void;
 }
 
+/**
+ * Block of memory allocated in the WASM heap that a Rive file can be written into directly (i.e
+ * from a fetch), and then imported with `loadFromBuffer()` without being copied again. Create it
+ * with a size of 0 and `append()` chunks to stream a file in as it downloads.
+ *
+ * Important: Make sure to delete this instance when it's no longer in use via the `delete()`
+ * method.
+ */
+export declare class FileBuffer {
+  /**
+   * Allocates a new buffer in the WASM heap
+   * @param size - Size of the buffer in bytes
+   */
+  constructor(size: number);
+  /**
+   * Returns a view of the buffer's memory to write the Rive file into. The view is invalidated
+   * if the WASM heap grows, so grab a new one after making any other calls into the runtime.
+   */
+  bytes(): Uint8Array;
+  /**
+   * Returns the size of the buffer in bytes; 0 once the buffer has been released
+   */
+  size(): number;
+  /**
+   * Preallocates room for the buffer to grow to the given size without reallocating
+   * @param capacity - Size in bytes to make room for
+   */
+  reserve(capacity: number): void;
+  /**
+   * Copies a chunk of bytes onto the end of the buffer, growing it as needed. Use this to
+   * stream a Rive file into the buffer as it downloads
+   * @param chunk - Bytes to append
+   */
+  append(chunk: Uint8Array): void;
+  /**
+   * Frees the buffer's memory
+   */
+  release(): void;
+  delete(): void;
+}
+
 /**
  * Rive class representing an Artboard instance. Use this class to create instances for
  * LinearAnimations, StateMachines, Nodes, Bones, and more. This Artboard instance should also be
@@ -359,6 +487,153 @@ export declare class Artboard {
    * @param name - Name of the transform component to grab a reference to
    */
   transformComponent(name: string): TransformComponent;
+  /**
+   * Returns the Bone for a handle from ComponentIndex.bone(), or null if the
+   * component at that handle isn't a Bone
+   * @param handle - Handle of the component
+   */
+  boneAt(handle: number): Bone | null;
+  /**
+   * Returns the Node for a handle from ComponentIndex.node(), or null if the
+   * component at that handle isn't a Node
+   * @param handle - Handle of the component
+   */
+  nodeAt(handle: number): Node | null;
+  /**
+   * Returns the root Bone for a handle from ComponentIndex.rootBone(), or null
+   * if the component at that handle isn't a root Bone
+   * @param handle - Handle of the component
+   */
+  rootBoneAt(handle: number): RootBone | null;
+  /**
+   * Returns the transform component for a handle from
+   * ComponentIndex.transformComponent(), or null if the component at that
+   * handle isn't a transform component
+   * @param handle - Handle of the component
+   */
+  transformComponentAt(handle: number): TransformComponent | null;
+}
+
+/**
+ * Resolves names on an Artboard to integer handles, once, for code that looks
+ * up the same named objects often. Pass component handles to the Artboard's
+ * nodeAt(), boneAt(), rootBoneAt() and transformComponentAt(), and animation
+ * and state machine handles to animationByIndex() and stateMachineByIndex().
+ *
+ * Each type has its own name table, so a handle is for the first object of
+ * that type with the name, as the Artboard's lookups by name find, even when
+ * an object of another type, such as a fill or a path, shares the name.
+ *
+ * Must be deleted before the Artboard it was created for.
+ */
+export declare class ComponentIndex {
+  constructor(artboard: Artboard);
+  /**
+   * Returns the handle of the first transform component with the given name,
+   * or -1 if there's none
+   */
+  transformComponent(name: string): number;
+  /**
+   * Returns the handle of the first Node with the given name, or -1 if there's
+   * none
+   */
+  node(name: string): number;
+  /**
+   * Returns the handle of the first Bone with the given name, or -1 if there's
+   * none
+   */
+  bone(name: string): number;
+  /**
+   * Returns the handle of the first root Bone with the given name, or -1 if
+   * there's none
+   */
+  rootBone(name: string): number;
+  /**
+   * Returns the index of the named animation, or -1 if there's none
+   */
+  animation(name: string): number;
+  /**
+   * Returns the index of the named state machine, or -1 if there's none
+   */
+  stateMachine(name: string): number;
+  delete(): void;
+}
+
+/**
+ * Local and world transforms of many transform components, in wasm memory, for
+ * reading and writing in bulk rather than a property at a time. Components are
+ * given as ComponentIndex handles; ones that aren't transform components read
+ * as zeros and are skipped when writing. The locals and worlds are read from
+ * the components when the batch is created, so a write() before any read()
+ * leaves untouched components as they were.
+ *
+ * Must be deleted before the Artboard it was created for.
+ */
+export declare class TransformBatch {
+  constructor(artboard: Artboard, handles: number[] | Int32Array);
+  /**
+   * Returns a view of the local transforms, 5 floats per component: x, y,
+   * rotation, scaleX, scaleY. The view is invalidated whenever wasm memory
+   * grows, so fetch a fresh one before use.
+   */
+  locals(): Float32Array;
+  /**
+   * Returns a view of the world transforms, 6 floats per component: xx, xy,
+   * yx, yy, tx, ty. The view is invalidated whenever wasm memory grows, so
+   * fetch a fresh one before use.
+   */
+  worlds(): Float32Array;
+  /**
+   * Fills the locals and worlds from the components. World transforms are
+   * updated when the artboard advances, so read after advancing.
+   */
+  read(): void;
+  /**
+   * Passes the locals back to the components. Bones' x and y are skipped, as
+   * their position follows their parent bone.
+   */
+  write(): void;
+  delete(): void;
+}
+
+/**
+ * Flattened path vertices packed into reusable wasm memory, for tooling that
+ * reads whole paths at once. Only in runtimes built with
+ * ENABLE_QUERY_FLAT_VERTICES.
+ *
+ * Each vertex is 7 floats: type, x, y, inX, inY, outX, outY, where type is 1
+ * for cubic vertices and 0 for straight ones, whose in and out points are the
+ * vertex itself. flattenAll() also lists each path as 3 uint32s: its index in
+ * the artboard's objects, its first vertex and its vertex count.
+ */
+export declare class FlattenedPathBuffer {
+  constructor();
+  /**
+   * Flattens the path at an index in the artboard's objects, replacing the
+   * buffer's contents
+   * @returns the path's vertex count, or -1 if there's no path at that index
+   */
+  flatten(
+    artboard: Artboard,
+    index: number,
+    transformToParent: boolean
+  ): number;
+  /**
+   * Flattens every path on the artboard, replacing the buffer's contents
+   * @returns the number of paths
+   */
+  flattenAll(artboard: Artboard, transformToParent: boolean): number;
+  /**
+   * Returns a view of the vertices. It's invalidated by the next flatten and
+   * whenever wasm memory grows.
+   */
+  vertices(): Float32Array;
+  /**
+   * Returns a view of the paths listed by flattenAll(). It's invalidated by
+   * the next flatten and whenever wasm memory grows.
+   */
+  paths(): Uint32Array;
+  delete(): void;
 }
 
 export declare class Bone extends TransformComponent {
@@ -509,6 +784,19 @@ export declare class StateMachineInstance {
    * @returns SMIInput reference
    */
   input(i: number): SMIInput;
+  /**
+   * Returns the index of the named input, or -1 if there's no such input. The
+   * index is a stable handle for setInputs() and StateMachineInputSlots.
+   * @param name - Name of the input
+   */
+  inputIndex(name: string): number;
+  /**
+   * Sets many inputs in a single call. Takes flat pairs of input index and
+   * value: number inputs take the value, booleans are set to whether it's
+   * nonzero, and triggers fire if it's nonzero.
+   * @param pairs - [index0, value0, index1, value1, ...]
+   */
+  setInputs(pairs: Float32Array | number[]): void;
   /**
    * Advances/scrubs the StateMachineInstance by the set amount of seconds. Note that this does not
    * apply changes to the properties of objects in the Artboard yet.
@@ -562,6 +850,104 @@ export declare class StateMachineInstance {
   delete(): void;
 }
 
+/**
+ * Pointer events for a StateMachineInstance, culled against the bounds of the
+ * shapes its listeners target before the state machine hit tests each shape.
+ * Bounds are measured at every event, so they follow animated shapes. State
+ * machines with nested artboard listeners are never culled.
+ */
+export declare class ListenerBounds {
+  constructor(stateMachineInstance: StateMachineInstance);
+  /**
+   * Passes a move on to the state machine unless both it and the last event
+   * passed on fall outside every listener's bounds
+   * @returns false if the move was culled
+   */
+  pointerMove(x: number, y: number): boolean;
+  pointerDown(x: number, y: number): void;
+  pointerUp(x: number, y: number): void;
+  /**
+   * Deletes the bounds; this must happen before the state machine instance is
+   * deleted
+   */
+  delete(): void;
+}
+
+/**
+ * Input values for a StateMachineInstance, one float per input in wasm memory,
+ * that can be written directly instead of through SMIInput objects. Values have
+ * the same meaning as in StateMachineInstance.setInputs().
+ */
+export declare class StateMachineInputSlots {
+  constructor(stateMachineInstance: StateMachineInstance);
+  /**
+   * Returns a view of the slots, indexed by input. The view is invalidated
+   * whenever wasm memory grows, so fetch a fresh one before writing.
+   */
+  values(): Float32Array;
+  /**
+   * Passes slots written since the last call on to their inputs where they
+   * differ from the inputs' current values, and puts fired trigger slots back
+   * to 0. Slots that weren't written take on their inputs' current values, so
+   * inputs set some other way aren't overwritten. NaN slots are ignored and
+   * reset. Call before advancing the state machine.
+   * @returns true if any input changed
+   */
+  apply(): boolean;
+  /**
+   * Deletes the slots; this must happen before the state machine instance is
+   * deleted
+   */
+  delete(): void;
+}
+
+/**
+ * Advances animation and state machine instances, recording state changes and
+ * loops in wasm memory. Each record is four uint32s: type
+ * (EventQueue.stateChange, EventQueue.loop or EventQueue.overflow), the tag
+ * passed in when advancing, the interned name id for state changes, and for
+ * overflows the number of records dropped.
+ */
+export declare class EventQueue {
+  static stateChange: number;
+  static loop: number;
+  static overflow: number;
+
+  constructor();
+  /**
+   * Advances the state machine instance, recording each state that changed
+   * @returns the same as StateMachineInstance.advance()
+   */
+  advanceStateMachine(
+    stateMachineInstance: StateMachineInstance,
+    tag: number,
+    sec: number
+  ): boolean;
+  /**
+   * Advances the animation instance, recording a loop if it looped
+   * @returns the same as LinearAnimationInstance.advance()
+   */
+  advanceAnimation(
+    animationInstance: LinearAnimationInstance,
+    tag: number,
+    sec: number
+  ): boolean;
+  /**
+   * Takes the oldest records not yet drained. Records that wrap around the end
+   * of the queue's ring come back from the next call, so call until the view
+   * is empty. The queue holds up to 4096 records; if more are recorded, the
+   * rest are dropped and the next call returns an overflow record. The view is
+   * invalidated by the next advance or call and whenever wasm memory grows.
+   */
+  drain(): Uint32Array;
+  /**
+   * Returns the interned name with the given id; names are only ever added,
+   * so ids stay valid for the life of the queue
+   */
+  name(id: number): string;
+  delete(): void;
+}
+
 export declare class SMIInput {
   // TODO: Keep only the base SMIInput properties and make SMIBool, SMINumber, SMITriger extend it
   static bool: number;
@@ -8,6 +8,8 @@ export interface TouchInteractionsParams {
   rive: rc.RiveCanvas;
   fit: rc.Fit;
   alignment: rc.Alignment;
+  // Called after pointer events are passed to the state machines
+  onInteraction?: () => void;
 }
 
 interface ClientCoordinates {
@@ -52,7 +54,11 @@ const getClientCoordinates = (
 
 /**
  * Registers mouse move/up/down callback handlers on the canvas to send meaningful coordinates to
- * the state machine pointer move/up/down functions based on cursor interaction
+ * the state machine pointer move/up/down functions based on cursor interaction.
+ *
+ * Pointer moves are coalesced: only the latest one is passed on, once per animation frame and
+ * ahead of the frame's animation callbacks. Pointer downs and ups are passed on right away, after
+ * any pending move.
  */
 export const registerTouchInteractions = ({
   canvas,
@@ -62,6 +68,7 @@ export const registerTouchInteractions = ({
   rive,
   fit,
   alignment,
+  onInteraction,
 }: TouchInteractionsParams) => {
   if (
     !canvas ||
@@ -74,17 +81,23 @@ export const registerTouchInteractions = ({
     return null;
   }
 
-  const processEventCallback = (event: MouseEvent | TouchEvent) => {
-    const boundingRect = (
-      event.currentTarget as HTMLCanvasElement
-    ).getBoundingClientRect();
+  // The canvas's client rect, and the matrix that maps from it to the
+  // artboard, are cached until the canvas moves or resizes.
+  let boundingRect: DOMRect | null = null;
+  let invertedMatrix: rc.Mat2D | null = null;
+  // Pointer events go through the bounds of each state machine's listeners,
+  // which skip hit testing moves that can't reach any of them
+  const targets: Array<rc.ListenerBounds | rc.StateMachineInstance> =
+    rive.ListenerBounds
+      ? stateMachines.map((sm) => new rive.ListenerBounds(sm))
+      : stateMachines;
 
-    const { clientX, clientY } = getClientCoordinates(event);
-    if (!clientX && !clientY) {
-      return;
-    }
-    const canvasX = clientX - boundingRect.left;
-    const canvasY = clientY - boundingRect.top;
+  const invalidateBoundingRect = () => {
+    boundingRect = null;
+  };
+
+  const updateBoundingRect = (): DOMRect => {
+    boundingRect = (canvas as HTMLCanvasElement).getBoundingClientRect();
     const forwardMatrix = rive.computeAlignment(
       fit,
       alignment,
@@ -96,8 +109,16 @@ export const registerTouchInteractions = ({
       },
       artboard.bounds
     );
-    const invertedMatrix = new rive.Mat2D();
+    invertedMatrix = invertedMatrix ?? new rive.Mat2D();
     forwardMatrix.invert(invertedMatrix);
+    forwardMatrix.delete();
+    return boundingRect;
+  };
+
+  const forwardPointer = (type: string, clientX: number, clientY: number) => {
+    const rect = boundingRect ?? updateBoundingRect();
+    const canvasX = clientX - rect.left;
+    const canvasY = clientY - rect.top;
     const canvasCoordinatesVector = new rive.Vec2D(canvasX, canvasY);
     const transformedVector = rive.mapXY(
       invertedMatrix,
@@ -107,38 +128,84 @@ export const registerTouchInteractions = ({
     const transformedY = transformedVector.y();
 
     transformedVector.delete();
-    invertedMatrix.delete();
     canvasCoordinatesVector.delete();
-    forwardMatrix.delete();
 
-    switch (event.type) {
+    switch (type) {
       // Pointer moving/hovering on the canvas
       case "touchmove":
       case "mouseover":
       case "mouseout":
       case "mousemove": {
-        for (const stateMachine of stateMachines) {
-          stateMachine.pointerMove(transformedX, transformedY);
+        let passedOn = false;
+        for (const target of targets) {
+          // State machines themselves don't report whether a move was culled
+          passedOn =
+            target.pointerMove(transformedX, transformedY) !== false ||
+            passedOn;
+        }
+        if (!passedOn) {
+          return;
         }
         break;
       }
       // Pointer click initiated but not released yet on the canvas
       case "touchstart":
       case "mousedown": {
-        for (const stateMachine of stateMachines) {
-          stateMachine.pointerDown(transformedX, transformedY);
+        for (const target of targets) {
+          target.pointerDown(transformedX, transformedY);
         }
         break;
       }
       // Pointer click released on the canvas
       case "touchend":
       case "mouseup": {
-        for (const stateMachine of stateMachines) {
-          stateMachine.pointerUp(transformedX, transformedY);
+        for (const target of targets) {
+          target.pointerUp(transformedX, transformedY);
         }
         break;
       }
       default:
+        return;
+    }
+    onInteraction?.();
+  };
+
+  // The latest pointer move that hasn't been passed on yet
+  let pendingMove: { type: string; clientX: number; clientY: number } | null =
+    null;
+  let pendingMoveRequestId = 0;
+  const flushPendingMove = () => {
+    pendingMoveRequestId = 0;
+    if (pendingMove) {
+      const { type, clientX, clientY } = pendingMove;
+      pendingMove = null;
+      forwardPointer(type, clientX, clientY);
+    }
+  };
+
+  const processEventCallback = (event: MouseEvent | TouchEvent) => {
+    const { clientX, clientY } = getClientCoordinates(event);
+    if (!clientX && !clientY) {
+      return;
+    }
+
+    switch (event.type) {
+      case "touchmove":
+      case "mouseover":
+      case "mouseout":
+      case "mousemove":
+        pendingMove = { type: event.type, clientX, clientY };
+        if (!rive.requestPreAnimationFrame) {
+          flushPendingMove();
+        } else if (!pendingMoveRequestId) {
+          pendingMoveRequestId =
+            rive.requestPreAnimationFrame(flushPendingMove);
+        }
+        break;
+      default:
+        // Keep the pointer's path in order.
+        flushPendingMove();
+        forwardPointer(event.type, clientX, clientY);
     }
   };
   const callback = processEventCallback.bind(this);
@@ -150,6 +217,18 @@ export const registerTouchInteractions = ({
   canvas.addEventListener("touchmove", callback);
   canvas.addEventListener("touchstart", callback);
   canvas.addEventListener("touchend", callback);
+  // Scrolling any ancestor moves the canvas's client rect.
+  window.addEventListener("scroll", invalidateBoundingRect, {
+    capture: true,
+    passive: true,
+  });
+  window.addEventListener("resize", invalidateBoundingRect);
+  const resizeObserver =
+    typeof ResizeObserver !== "undefined" &&
+    canvas instanceof HTMLCanvasElement
+      ? new ResizeObserver(invalidateBoundingRect)
+      : null;
+  resizeObserver?.observe(canvas as HTMLCanvasElement);
   return () => {
     canvas.removeEventListener("mouseover", callback);
     canvas.removeEventListener("mouseout", callback);
@@ -159,5 +238,23 @@ export const registerTouchInteractions = ({
     canvas.removeEventListener("touchmove", callback);
     canvas.removeEventListener("touchstart", callback);
     canvas.removeEventListener("touchend", callback);
+    window.removeEventListener("scroll", invalidateBoundingRect, {
+      capture: true,
+    });
+    window.removeEventListener("resize", invalidateBoundingRect);
+    resizeObserver?.disconnect();
+    if (pendingMoveRequestId) {
+      rive.cancelAnimationFrame(pendingMoveRequestId);
+      pendingMoveRequestId = 0;
+    }
+    pendingMove = null;
+    boundingRect = null;
+    invertedMatrix?.delete();
+    invertedMatrix = null;
+    if (rive.ListenerBounds) {
+      for (const target of targets as rc.ListenerBounds[]) {
+        target.delete();
+      }
+    }
   };
 };
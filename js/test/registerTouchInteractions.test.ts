@@ -105,3 +105,138 @@ test("touchend event can invoke pointerUp", (): void => {
   expect(mockStateMachines[0].pointerMove).not.toBeCalledWith();
   expect(mockStateMachines[0].pointerUp).toBeCalledWith(100, 100);
 });
+
+test("pointer events invoke onInteraction", (): void => {
+  const interactiveCanvas = document.createElement("canvas");
+  const onInteraction = jest.fn(() => {
+    expect(mockStateMachines[0].pointerDown).toBeCalledWith(100, 100);
+  });
+  registerTouchInteractions({
+    canvas: interactiveCanvas,
+    artboard: mockArtboard as rc.Artboard,
+    stateMachines: mockStateMachines as unknown as rc.StateMachineInstance[],
+    renderer: renderer as rc.Renderer,
+    rive: mockRive as unknown as rc.RiveCanvas,
+    fit: mockFit as rc.Fit,
+    alignment: mockAlignment as rc.Alignment,
+    onInteraction,
+  });
+
+  interactiveCanvas.dispatchEvent(
+    new TouchEvent("touchstart", {
+      touches: [mockTouchPoint],
+    })
+  );
+
+  expect(onInteraction).toBeCalledTimes(1);
+});
+
+// #endregion
+
+// #region test pointer move coalescing
+
+const registerWithPreAnimationFrame = () => {
+  const frameCallbacks: (() => void)[] = [];
+  const rive = {
+    ...mockRive,
+    computeAlignment: jest.fn(() => mockMat2D),
+    requestPreAnimationFrame: jest.fn((cb: () => void) => {
+      frameCallbacks.push(cb);
+      return frameCallbacks.length;
+    }),
+    cancelAnimationFrame: jest.fn(),
+  };
+  const coalescingCanvas = document.createElement("canvas");
+  registerTouchInteractions({
+    canvas: coalescingCanvas,
+    artboard: mockArtboard as rc.Artboard,
+    stateMachines: mockStateMachines as unknown as rc.StateMachineInstance[],
+    renderer: renderer as rc.Renderer,
+    rive: rive as unknown as rc.RiveCanvas,
+    fit: mockFit as rc.Fit,
+    alignment: mockAlignment as rc.Alignment,
+  });
+  const runFrame = () => frameCallbacks.splice(0).forEach((cb) => cb());
+  return { rive, coalescingCanvas, runFrame };
+};
+
+test("pointer moves are coalesced to one per frame", (): void => {
+  const { rive, coalescingCanvas, runFrame } = registerWithPreAnimationFrame();
+  for (const clientX of [10, 20, 30]) {
+    coalescingCanvas.dispatchEvent(
+      new MouseEvent("mousemove", { clientX, clientY: 5 })
+    );
+  }
+
+  expect(mockStateMachines[0].pointerMove).not.toBeCalled();
+  expect(rive.requestPreAnimationFrame).toBeCalledTimes(1);
+  runFrame();
+  expect(mockStateMachines[0].pointerMove).toBeCalledTimes(1);
+  expect(mockStateMachines[0].pointerMove).toBeCalledWith(30, 5);
+  // The alignment is only computed once for all the events
+  expect(rive.computeAlignment).toBeCalledTimes(1);
+});
+
+test("pointer down passes on a pending move first", (): void => {
+  const { coalescingCanvas, runFrame } = registerWithPreAnimationFrame();
+  const calls: string[] = [];
+  (mockStateMachines[0].pointerMove as jest.Mock).mockImplementation(() =>
+    calls.push("move")
+  );
+  (mockStateMachines[0].pointerDown as jest.Mock).mockImplementation(() =>
+    calls.push("down")
+  );
+  coalescingCanvas.dispatchEvent(
+    new MouseEvent("mousemove", { clientX: 10, clientY: 5 })
+  );
+  coalescingCanvas.dispatchEvent(
+    new MouseEvent("mousedown", { clientX: 20, clientY: 5 })
+  );
+
+  expect(calls).toEqual(["move", "down"]);
+  runFrame();
+  expect(mockStateMachines[0].pointerMove).toBeCalledTimes(1);
+});
+
+test("pointer moves outside every listener's bounds aren't passed on", (): void => {
+  const moves: boolean[] = [];
+  const listenerBounds = {
+    pointerMove: jest.fn(() => moves.shift()),
+    pointerDown: jest.fn(),
+    pointerUp: jest.fn(),
+    delete: jest.fn(),
+  };
+  const onInteraction = jest.fn();
+  const boundedCanvas = document.createElement("canvas");
+  const cleanup = registerTouchInteractions({
+    canvas: boundedCanvas,
+    artboard: mockArtboard as rc.Artboard,
+    stateMachines: mockStateMachines,
+    renderer: renderer as rc.Renderer,
+    rive: {
+      ...mockRive,
+      ListenerBounds: jest.fn(() => listenerBounds),
+    } as unknown as rc.RiveCanvas,
+    fit: mockFit as rc.Fit,
+    alignment: mockAlignment as rc.Alignment,
+    onInteraction,
+  });
+
+  moves.push(false, true);
+  boundedCanvas.dispatchEvent(
+    new MouseEvent("mousemove", { clientX: 10, clientY: 5 })
+  );
+  expect(listenerBounds.pointerMove).toBeCalledWith(10, 5);
+  expect(onInteraction).not.toBeCalled();
+  boundedCanvas.dispatchEvent(
+    new MouseEvent("mousemove", { clientX: 10, clientY: 5 })
+  );
+  expect(onInteraction).toBeCalledTimes(1);
+  // Hit testing is left to the bounds
+  expect(mockStateMachines[0].pointerMove).not.toBeCalled();
+
+  cleanup();
+  expect(listenerBounds.delete).toBeCalled();
+});
+
+// #endregion
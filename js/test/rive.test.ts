@@ -1224,6 +1224,436 @@ test("Statemachines have pointer events", (done) => {
   });
 });
 
+// #region idle rendering
+
+// Has every animation, state machine and the artboard report whether they'll
+// keep changing, then draws a frame
+const drawWithAdvance = (r: rive.Rive, needsAdvance: boolean): void => {
+  const internals = r as any;
+  for (const animatable of [
+    ...internals.animator.animations,
+    ...internals.animator.stateMachines,
+  ]) {
+    jest.spyOn(animatable, "advance").mockReturnValue(needsAdvance);
+  }
+  jest.spyOn(internals.artboard, "advance").mockReturnValue(needsAdvance);
+  internals.draw(performance.now());
+};
+
+// Creates a playing state machine instance, calling back once it's ready
+const playingStateMachine = (onReady: (r: rive.Rive) => void): void => {
+  let ready = false;
+  const r = new rive.Rive({
+    canvas: document.createElement("canvas"),
+    buffer: stateMachineFileBuffer,
+    stateMachines: "StateMachine",
+    autoplay: true,
+    onPlay: () => {
+      if (!ready) {
+        ready = true;
+        // Take over from the render loop so frames are only drawn by the test
+        r.stopRendering();
+        onReady(r);
+      }
+    },
+  });
+};
+
+test("Rendering stops once nothing needs advancing", (done) => {
+  playingStateMachine((r) => {
+    const startRendering = jest.spyOn(r, "startRendering");
+    drawWithAdvance(r, false);
+    expect(startRendering).not.toBeCalled();
+    expect(r.isPlaying).toBe(true);
+    r.cleanup();
+    done();
+  });
+});
+
+test("Rendering continues while anything needs advancing", (done) => {
+  playingStateMachine((r) => {
+    const startRendering = jest.spyOn(r, "startRendering");
+    drawWithAdvance(r, true);
+    expect(startRendering).toBeCalledTimes(1);
+    r.cleanup();
+    done();
+  });
+});
+
+test("Idle rendering restarts on wake, input changes, resize and play", (done) => {
+  playingStateMachine((r) => {
+    const startRendering = jest.spyOn(r, "startRendering");
+    const idle = () => {
+      r.stopRendering();
+      drawWithAdvance(r, false);
+      startRendering.mockClear();
+    };
+
+    idle();
+    (r as any).wake();
+    expect(startRendering).toBeCalledTimes(1);
+
+    idle();
+    r.stateMachineInputs("StateMachine")[0].value = 12;
+    expect(startRendering).toBeCalledTimes(1);
+
+    idle();
+    r.setStateMachineInputs("StateMachine", [0, 13]);
+    expect(startRendering).toBeCalledTimes(1);
+
+    idle();
+    const slots = r.stateMachineInputSlots("StateMachine");
+    slots.values()[0] = 14;
+    expect(startRendering).not.toBeCalled();
+    slots.commit();
+    expect(startRendering).toBeCalledTimes(1);
+
+    idle();
+    r.layout = new rive.Layout({ fit: rive.Fit.Cover });
+    expect(startRendering).toBeCalledTimes(1);
+
+    idle();
+    r.play();
+    expect(startRendering).toBeCalled();
+
+    r.cleanup();
+    done();
+  });
+});
+
+test("Waking does nothing while rendering hasn't stopped", (done) => {
+  playingStateMachine((r) => {
+    drawWithAdvance(r, true);
+    r.stopRendering();
+    const startRendering = jest.spyOn(r, "startRendering");
+    (r as any).wake();
+    expect(startRendering).not.toBeCalled();
+    r.cleanup();
+    done();
+  });
+});
+
+test("Resizing and changing the layout redraw the whole canvas", (done) => {
+  playingStateMachine((r) => {
+    const invalidate = jest.spyOn((r as any).renderer, "invalidate");
+    r.resizeToCanvas();
+    expect(invalidate).toBeCalledTimes(1);
+    r.layout = new rive.Layout({ fit: rive.Fit.Cover });
+    expect(invalidate).toBeCalled();
+    r.cleanup();
+    done();
+  });
+});
+
+// #endregion
+
+// #region damage tracking
+
+// Clears a canvas renderer in an animation callback, which flushes its frame
+// to the canvas once the callback returns
+const drawEmptyFrame = (
+  runtime: rc.RiveCanvas,
+  renderer: rc.CanvasRenderer
+): Promise<void> =>
+  new Promise((resolve) => {
+    runtime.requestAnimationFrame(() => {
+      renderer.clear();
+      renderer.flush();
+      resolve();
+    });
+  });
+
+// Creates a 100x100 canvas with a renderer that has drawn its first frame
+const canvasWithRenderer = async () => {
+  const runtime: rc.RiveCanvas = await rive.RuntimeLoader.awaitInstance();
+  const canvas = document.createElement("canvas");
+  canvas.width = 100;
+  canvas.height = 100;
+  const renderer = runtime.makeRenderer(canvas);
+  await drawEmptyFrame(runtime, renderer);
+  const clearRect = jest.spyOn(canvas.getContext("2d"), "clearRect");
+  return { runtime, canvas, renderer, clearRect };
+};
+
+test("Frames where nothing changed aren't drawn", async () => {
+  const { runtime, renderer, clearRect } = await canvasWithRenderer();
+  await drawEmptyFrame(runtime, renderer);
+  expect(clearRect).not.toBeCalled();
+  renderer.delete();
+});
+
+test("Assigning a canvas its own width redraws the whole canvas", async () => {
+  const { runtime, canvas, renderer, clearRect } = await canvasWithRenderer();
+  // Browsers reset the context along with the canvas's pixels, which
+  // jest-canvas-mock doesn't do
+  canvas.width = 100;
+  canvas.getContext("2d").lineDashOffset = 0;
+  await drawEmptyFrame(runtime, renderer);
+  expect(clearRect).toBeCalledWith(0, 0, 100, 100);
+  renderer.delete();
+});
+
+test("Paths drawn again with the same geometry aren't sent again", async () => {
+  const { runtime, renderer } = await canvasWithRenderer();
+  const path = runtime.renderFactory.makeRenderPath();
+  const paint = runtime.renderFactory.makeRenderPaint();
+  // The typings name rewind() reset()
+  const rebuild = (size: number) => {
+    (path as unknown as { rewind(): void }).rewind();
+    path.moveTo(10, 10);
+    path.lineTo(size, 10);
+    path.lineTo(size, size);
+    path.close();
+  };
+  const drawPathFrame = (): Promise<number> =>
+    new Promise((resolve) => {
+      runtime.requestAnimationFrame(() => {
+        renderer.clear();
+        renderer.drawPath(path, paint);
+        const syncs = renderer.pathSyncCount();
+        renderer.flush();
+        resolve(syncs);
+      });
+    });
+
+  rebuild(50);
+  expect(await drawPathFrame()).toBe(1);
+  expect(await drawPathFrame()).toBe(0);
+  rebuild(50);
+  expect(await drawPathFrame()).toBe(0);
+  rebuild(60);
+  expect(await drawPathFrame()).toBe(1);
+  renderer.delete();
+});
+
+// #endregion
+
+// #region persistent cache
+
+// Minimal stand-ins for the Fetch and Cache Storage APIs, which jsdom lacks
+class FakeResponse {
+  public readonly status: number;
+  private readonly headerMap: Map<string, string>;
+
+  constructor(
+    private readonly body: string,
+    init: { status?: number; headers?: Record<string, string> } = {}
+  ) {
+    this.status = init.status ?? 200;
+    this.headerMap = new Map();
+    for (const [name, value] of Object.entries(init.headers ?? {})) {
+      this.headerMap.set(name.toLowerCase(), value);
+    }
+  }
+
+  public get ok(): boolean {
+    return this.status >= 200 && this.status < 300;
+  }
+
+  public get headers() {
+    return {
+      get: (name: string) => this.headerMap.get(name.toLowerCase()) ?? null,
+      has: (name: string) => this.headerMap.has(name.toLowerCase()),
+    };
+  }
+
+  public clone(): FakeResponse {
+    return new FakeResponse(this.body, {
+      status: this.status,
+      headers: Object.fromEntries(this.headerMap),
+    });
+  }
+
+  public text(): Promise<string> {
+    return Promise.resolve(this.body);
+  }
+
+  public arrayBuffer(): Promise<ArrayBuffer> {
+    return Promise.resolve(
+      arrayToArrayBuffer(Array.from(this.body, (c) => c.charCodeAt(0)))
+    );
+  }
+}
+
+// Sets up an empty Cache Storage, returning the caches by name
+const fakeCaches = (): Map<string, Map<string, FakeResponse>> => {
+  const stores = new Map<string, Map<string, FakeResponse>>();
+  const open = (name: string) => {
+    if (!stores.has(name)) {
+      stores.set(name, new Map());
+    }
+    const store = stores.get(name);
+    return Promise.resolve({
+      match: (key: string) => Promise.resolve(store.get(key)),
+      put: (key: string, res: FakeResponse) => {
+        store.set(key, res);
+        return Promise.resolve();
+      },
+      delete: (key: string) => Promise.resolve(store.delete(key)),
+    });
+  };
+  Object.assign(global, {
+    caches: { open, keys: () => Promise.resolve([...stores.keys()]) },
+    Request: class {
+      constructor(public readonly url: string) {}
+    },
+    Response: FakeResponse,
+  });
+  return stores;
+};
+
+// Fills the file and digest caches for a src
+const storeFile = async (src: string, res: FakeResponse, digest: string) => {
+  await rive.PersistentCache.putFile(src, res as unknown as Response);
+  await rive.PersistentCache.putDigest(src, digest);
+};
+
+// The globals the fakes replace, put back after each test
+const fakedGlobals = ["caches", "fetch", "crypto", "Request", "Response"];
+const realGlobals = fakedGlobals.map((name) =>
+  Object.getOwnPropertyDescriptor(global, name)
+);
+afterEach(() => {
+  fakedGlobals.forEach((name, i) => {
+    if (realGlobals[i]) {
+      Object.defineProperty(global, name, realGlobals[i]);
+    } else {
+      delete (global as any)[name];
+    }
+  });
+});
+
+test("Cached Rive files are served from the cache without a network request", async () => {
+  fakeCaches();
+  const cachedResponse = new FakeResponse("riv", { headers: { ETag: "a" } });
+  await storeFile("https://a.rive/file.riv", cachedResponse, "abc");
+  global.fetch = jest.fn();
+
+  const { cached, response } = await rive.PersistentCache.fetchFile(
+    "https://a.rive/file.riv"
+  );
+  expect(response).toBeUndefined();
+  expect(cached.response).toBe(cachedResponse);
+  expect(cached.digest).toBe("abc");
+  expect(global.fetch).not.toBeCalled();
+});
+
+test("Cache misses go to the network", async () => {
+  fakeCaches();
+  const networkResponse = new FakeResponse("riv");
+  global.fetch = jest.fn(() =>
+    Promise.resolve(networkResponse as unknown as Response)
+  );
+
+  const { cached, response } = await rive.PersistentCache.fetchFile(
+    "https://a.rive/file.riv"
+  );
+  expect(global.fetch).toBeCalledTimes(1);
+  expect(cached).toBeUndefined();
+  expect(response).toBe(networkResponse);
+});
+
+test("Cached Rive files aren't used until their digest is stored", async () => {
+  fakeCaches();
+  await rive.PersistentCache.putFile(
+    "https://a.rive/file.riv",
+    new FakeResponse("riv") as unknown as Response
+  );
+  expect(
+    await rive.PersistentCache.matchFile("https://a.rive/file.riv")
+  ).toBeUndefined();
+});
+
+test("Revalidating an unchanged Rive file only makes a HEAD request", async () => {
+  fakeCaches();
+  const cachedResponse = new FakeResponse("riv", { headers: { ETag: "a" } });
+  await storeFile("https://a.rive/file.riv", cachedResponse, "abc");
+  global.fetch = jest.fn(() =>
+    Promise.resolve(
+      new FakeResponse("", { headers: { ETag: "a" } }) as unknown as Response
+    )
+  );
+
+  await rive.PersistentCache.revalidateFile(
+    "https://a.rive/file.riv",
+    cachedResponse as unknown as Response
+  );
+  expect(global.fetch).toBeCalledTimes(1);
+  expect((global.fetch as jest.Mock).mock.calls[0][1].method).toBe("HEAD");
+});
+
+test("Revalidating a changed Rive file replaces the cached copy", async () => {
+  const stores = fakeCaches();
+  const cachedResponse = new FakeResponse("riv", { headers: { ETag: "a" } });
+  await storeFile("https://a.rive/file.riv", cachedResponse, "abc");
+  const newResponse = new FakeResponse("riv2", { headers: { ETag: "b" } });
+  global.fetch = jest.fn((_src, init) =>
+    Promise.resolve(
+      (init.method === "HEAD"
+        ? new FakeResponse("", { headers: { ETag: "b" } })
+        : newResponse) as unknown as Response
+    )
+  );
+  const digest = jest.fn(() => Promise.resolve(new ArrayBuffer(32)));
+  Object.defineProperty(global, "crypto", {
+    value: { subtle: { digest } },
+    configurable: true,
+  });
+
+  await rive.PersistentCache.revalidateFile(
+    "https://a.rive/file.riv",
+    cachedResponse as unknown as Response
+  );
+  expect(global.fetch).toBeCalledTimes(2);
+  const cached = await rive.PersistentCache.matchFile(
+    "https://a.rive/file.riv"
+  );
+  expect(cached.response).toBe(newResponse);
+  expect(cached.digest).toBe("0".repeat(64));
+  expect(stores.size).toBe(2);
+});
+
+test("A failed download doesn't drop the cached copy when revalidating", async () => {
+  fakeCaches();
+  const cachedResponse = new FakeResponse("riv", { headers: { ETag: "a" } });
+  await storeFile("https://a.rive/file.riv", cachedResponse, "abc");
+  // A download that's cut off partway through
+  class AbortedResponse extends FakeResponse {
+    public clone(): FakeResponse {
+      return this;
+    }
+    public arrayBuffer(): Promise<ArrayBuffer> {
+      return Promise.reject(new Error("aborted"));
+    }
+  }
+  const newResponse = new AbortedResponse("riv2", { headers: { ETag: "b" } });
+  global.fetch = jest.fn((_src, init) =>
+    Promise.resolve(
+      (init.method === "HEAD"
+        ? new FakeResponse("", { headers: { ETag: "b" } })
+        : newResponse) as unknown as Response
+    )
+  );
+  Object.defineProperty(global, "crypto", {
+    value: { subtle: { digest: () => Promise.resolve(new ArrayBuffer(32)) } },
+    configurable: true,
+  });
+
+  await expect(
+    rive.PersistentCache.revalidateFile(
+      "https://a.rive/file.riv",
+      cachedResponse as unknown as Response
+    )
+  ).rejects.toThrow("aborted");
+  const cached = await rive.PersistentCache.matchFile(
+    "https://a.rive/file.riv"
+  );
+  expect(cached.response).toBe(cachedResponse);
+  expect(cached.digest).toBe("abc");
+});
+
+// #endregion
+
 // #region cleanup
 
 test("Rive deletes instances on the cleanup", (done) => {
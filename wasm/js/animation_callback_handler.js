@@ -4,43 +4,75 @@ function AnimationCallbackHandler() {
     let _mainAnimationCallbackID = 0;
     let _lastAnimationSubCallbackID = 0;
     let _animationSubCallbacks = new Map();
+    let _preAnimationCallbacks = new Map();
     let _fpsCounter = null;
     let _fpsDiv = null;
 
     this.requestAnimationFrame = function(callback) {
-        if (!_mainAnimationCallbackID) {
-            _mainAnimationCallbackID =
-                    requestAnimationFrame(mainAnimationCallback.bind(this));
-        }
+        requestMainAnimationCallback.call(this);
         const id = ++_lastAnimationSubCallbackID;
         _animationSubCallbacks.set(id, callback);
         return id;
     }
 
+    // Like requestAnimationFrame, but the callback is invoked ahead of every regular animation
+    // callback in the frame, e.g. to deliver coalesced input before the frame that responds to it.
+    // Cancel with cancelAnimationFrame.
+    this.requestPreAnimationFrame = function(callback) {
+        requestMainAnimationCallback.call(this);
+        const id = ++_lastAnimationSubCallbackID;
+        _preAnimationCallbacks.set(id, callback);
+        return id;
+    }
+
     this.cancelAnimationFrame = function(id) {
         _animationSubCallbacks.delete(id);
-        if (_mainAnimationCallbackID && _animationSubCallbacks.size == 0) {
+        _preAnimationCallbacks.delete(id);
+        if (_mainAnimationCallbackID && _animationSubCallbacks.size == 0 &&
+            _preAnimationCallbacks.size == 0) {
             cancelAnimationFrame(_mainAnimationCallbackID);
             _mainAnimationCallbackID = 0;
         }
     }
 
+    function requestMainAnimationCallback() {
+        if (!_mainAnimationCallbackID) {
+            _mainAnimationCallbackID =
+                    requestAnimationFrame(mainAnimationCallback.bind(this));
+        }
+    }
+
+    function invokeCallbacks(callbacks, time) {
+        callbacks.forEach((callback) => {
+            try {
+                callback(time);
+            } catch (err) {
+                console.error(err);
+            }
+        });
+    }
+
     function mainAnimationCallback(time) {
+        // The main callback still counts as pending while the pre-animation callbacks run, so
+        // animation callbacks they request get invoked in this same frame.
+        const flushingPreCallbacks = _preAnimationCallbacks;
+        _preAnimationCallbacks = new Map();
+        invokeCallbacks(flushingPreCallbacks, time);
+
         // Snap off and reset the sub-callbacks first, since they might call requestAnimationFrame
         // recursively.
         const flushingSubCallbacks = _animationSubCallbacks;
         _mainAnimationCallbackID = 0;
-        _lastAnimationSubCallbackID = 0;
         _animationSubCallbacks = new Map();
+        if (_preAnimationCallbacks.size == 0) {
+            _lastAnimationSubCallbackID = 0;
+        } else {
+            // A pre-animation callback requested another one, for the next frame.
+            requestMainAnimationCallback.call(this);
+        }
 
         // Invoke all pending animation callbacks.
-        flushingSubCallbacks.forEach((callback) => {
-            try {
-                callback(time);
-            } catch (err) {
-                console.error(err);
-            }
-        });
+        invokeCallbacks(flushingSubCallbacks, time);
 
         this.onAfterCallbacks();
 
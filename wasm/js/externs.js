@@ -1,5 +1,6 @@
 var Rive = {
     load: function () {},
+    loadFromBuffer: function () {},
     RenderPaintStyle: {
         fill: {},
         stroke: {}
@@ -1,13 +1,24 @@
-function makeMatrix(xx, xy, yx, yy, tx, ty) {
-  const m = new DOMMatrix();
-  m.a = xx;
-  m.b = xy;
-  m.c = yx;
-  m.d = yy;
-  m.e = tx;
-  m.f = ty;
-  return m;
-}
+// Path verbs recorded by RenderPathWrapper in bindings_c2d.cpp.
+const PATH_VERB_MOVE = 0;
+const PATH_VERB_LINE = 1;
+const PATH_VERB_CUBIC = 2;
+const PATH_VERB_CLOSE = 3;
+
+// Draw command opcodes recorded by RendererWrapper in bindings_c2d.cpp.
+const CMD_SAVE = 0;
+const CMD_RESTORE = 1;
+const CMD_SET_TRANSFORM = 2;
+const CMD_DRAW_PATH = 3;
+const CMD_CLIP_PATH = 4;
+const CMD_DRAW_IMAGE = 5;
+const CMD_CLEAR = 6;
+const CMD_DRAW_DEFERRED = 7;
+
+// Left in each canvas context's lineDashOffset after a frame is drawn, where it has no effect
+// since no dash pattern is ever set. Assigning the canvas's width or height wipes its pixels and
+// resets the context's state, even if the size doesn't change, so the mark going missing means
+// the next frame has to redraw the whole canvas.
+const FRAME_MARK_DASH_OFFSET = 1;
 
 const VTX_ARRAY = 0;
 const UV_ARRAY = 1;
@@ -31,7 +42,8 @@ const offscreenWebGL = new (function () {
         "stencil": 0,
         "antialias": 0,
         "premultipliedAlpha": 1,
-        "preserveDrawingBuffer": 0,
+        // The atlas keeps meshes drawn on previous frames.
+        "preserveDrawingBuffer": 1,
         "preferLowPowerToHighPerformance": 0,
         "failIfMajorPerformanceCaveat": 0,
         "enableExtensionsByDefault": 1,
@@ -169,36 +181,48 @@ const offscreenWebGL = new (function () {
     10 /*aligned to multiples of 1024*/
   );
 
-  this.drawMeshAtlas = function (
-    atlasWidth,
-    atlasHeight,
-    meshes,
-    numTotalVertexFloats,
-    numTotalIndices
-  ) {
+  // Sizes the atlas canvas to the largest size it has been asked to fit within the last second,
+  // in steps of 256, so it shrinks back after a burst of meshes without thrashing. Returns true if
+  // the canvas was resized, which loses everything that was drawn into it.
+  this.resizeAtlas = function (atlasWidth, atlasHeight) {
+    if (!initGL()) {
+      return false;
+    }
+    const canvasWidth = _maxRecentAtlasWidth.push(Math.max(atlasWidth, 1));
+    const canvasHeight = _maxRecentAtlasHeight.push(Math.max(atlasHeight, 1));
+    if (_gl.canvas.width == canvasWidth && _gl.canvas.height == canvasHeight) {
+      return false;
+    }
+    _gl.canvas.width = canvasWidth;
+    _gl.canvas.height = canvasHeight;
+    return true;
+  };
+
+  // Draws meshes into their regions of the atlas. Everything else in the atlas is left as is,
+  // unless 'clear' is set. 'atlas' has views over the meshes' vertices, UVs and indices, which
+  // bindings_c2d.cpp has already transformed into atlas pixel space and laid out in the same
+  // order as 'meshes'. Each mesh's indices are relative to its 'atlasBaseVertex'.
+  this.drawMeshAtlas = function (meshes, atlas, clear) {
     if (!initGL()) {
       return;
     }
 
-    const canvasWidth = _maxRecentAtlasWidth.push(atlasWidth);
-    const canvasHeight = _maxRecentAtlasHeight.push(atlasHeight);
-    if (_gl.canvas.width != canvasWidth || _gl.canvas.height != canvasHeight) {
-      _gl.canvas.width = canvasWidth;
-      _gl.canvas.height = canvasHeight;
+    const canvasWidth = _gl.canvas.width;
+    const canvasHeight = _gl.canvas.height;
+    _gl.viewport(0, 0, canvasWidth, canvasHeight);
+    if (clear) {
+      _gl.disable(_gl.SCISSOR_TEST);
+      _gl.clearColor(0, 0, 0, 0);
+      _gl.clear(_gl.COLOR_BUFFER_BIT);
     }
-    _gl.viewport(0, canvasHeight - atlasHeight, atlasWidth, atlasHeight);
-    _gl.disable(_gl.SCISSOR_TEST);
-    _gl.clearColor(0, 0, 0, 0);
-    _gl.clear(_gl.COLOR_BUFFER_BIT);
     _gl.enable(_gl.SCISSOR_TEST);
 
-    // Sort the meshes into a draw order that minimizes the cost of GL state changes.
-    meshes.sort((a, b) => b.sortKey - a.sortKey);
-
     const SIZE_OF_FLOAT = 4;
     const SIZE_OF_U16 = 2;
+    const numTotalVertexFloats = atlas.vertices.length;
+    const numTotalIndices = atlas.indices.length;
 
-    // Upload all vertices.
+    // Upload all vertices, then all uv, each with a single call.
     const vertexBufferLength =
       _maxRecentVertexLength.push(numTotalVertexFloats);
     if (_vertexBufferLength != vertexBufferLength) {
@@ -209,21 +233,9 @@ const offscreenWebGL = new (function () {
       );
       _vertexBufferLength = vertexBufferLength;
     }
-    let vOffset = 0;
-    for (const m of meshes) {
-      _gl.bufferSubData(_gl.ARRAY_BUFFER, vOffset, m.vtx);
-      vOffset += m.vtx.length * SIZE_OF_FLOAT;
-    }
-    console.assert(vOffset == numTotalVertexFloats * SIZE_OF_FLOAT);
-
-    // Upload all uv.
-    for (const m of meshes) {
-      _gl.bufferSubData(_gl.ARRAY_BUFFER, vOffset, m.uv);
-      vOffset += m.uv.length * SIZE_OF_FLOAT;
-    }
-    console.assert(
-      vOffset == numTotalVertexFloats * 2 /*count uv as well*/ * SIZE_OF_FLOAT
-    );
+    const uvOffset = vertexBufferLength * SIZE_OF_FLOAT;
+    _gl.bufferSubData(_gl.ARRAY_BUFFER, 0, atlas.vertices);
+    _gl.bufferSubData(_gl.ARRAY_BUFFER, uvOffset, atlas.uvs);
 
     // Upload all indices.
     const indexBufferLength = _maxRecentIndexLength.push(numTotalIndices);
@@ -235,18 +247,21 @@ const offscreenWebGL = new (function () {
       );
       _indexBufferLength = indexBufferLength;
     }
-    let iOffset = 0;
-    for (const m of meshes) {
-      _gl.bufferSubData(_gl.ELEMENT_ARRAY_BUFFER, iOffset, m.indices);
-      iOffset += m.indices.length * SIZE_OF_U16;
-    }
-    console.assert(iOffset == numTotalIndices * SIZE_OF_U16);
+    _gl.bufferSubData(_gl.ELEMENT_ARRAY_BUFFER, 0, atlas.indices);
 
-    // Draw all meshes.
+    // The vertices are already in atlas pixel space, so every mesh shares the same transform
+    // into normalized OpenGL clip space (-1..1).
+    _gl.uniform4f(_matUniform, 2 / canvasWidth, 0, 0, -2 / canvasHeight);
+    _gl.uniform2f(_translateUniform, -1, 1);
+
+    // Draw all meshes, merging runs that share a texture and don't need a scissor into a single
+    // drawElements.
     let boundTextureID = 0;
     let hasScissor = true;
-    vOffset = iOffset = 0;
-    for (const m of meshes) {
+    let boundBaseVertex = -1;
+    let indexOffset = 0;
+    for (let i = 0; i < meshes.length; ) {
+      const m = meshes[i];
       if (m.image._uniqueID != boundTextureID) {
         _gl.bindTexture(_gl.TEXTURE_2D, m.image._texture || null);
         boundTextureID = m.image._uniqueID;
@@ -261,49 +276,44 @@ const offscreenWebGL = new (function () {
         );
         hasScissor = true;
       } else if (hasScissor) {
-        _gl.scissor(0, canvasHeight - atlasHeight, atlasWidth, atlasHeight);
+        _gl.scissor(0, 0, canvasWidth, canvasHeight);
         hasScissor = false;
       }
 
-      // Draw the top-left corner of the mesh at location (atlasX, atlasY) in the WebGL
-      // canvas, scaled by (scaleX, scaleY).
-      // Post-transform the canvas2d's matrix into normalized OpenGL clip space (-1..1).
-      const iw = 2 / atlasWidth;
-      const ih = -2 / atlasHeight;
-      _gl.uniform4f(
-        _matUniform,
-        m.mat[0] * iw * m.scaleX,
-        m.mat[1] * ih * m.scaleY,
-        m.mat[2] * iw * m.scaleX,
-        m.mat[3] * ih * m.scaleY
-      );
-      _gl.uniform2f(
-        _translateUniform,
-        m.mat[4] * iw * m.scaleX + iw * (m.atlasX - m.meshX * m.scaleX) - 1,
-        m.mat[5] * ih * m.scaleY + ih * (m.atlasY - m.meshY * m.scaleY) + 1
-      );
+      if (m.atlasBaseVertex != boundBaseVertex) {
+        const vOffset = m.atlasBaseVertex * 2 * SIZE_OF_FLOAT;
+        _gl.vertexAttribPointer(VTX_ARRAY, 2, _gl.FLOAT, false, 0, vOffset);
+        _gl.vertexAttribPointer(
+          UV_ARRAY,
+          2,
+          _gl.FLOAT,
+          false,
+          0,
+          uvOffset + vOffset
+        );
+        boundBaseVertex = m.atlasBaseVertex;
+      }
 
-      _gl.vertexAttribPointer(VTX_ARRAY, 2, _gl.FLOAT, false, 0, vOffset);
-      _gl.vertexAttribPointer(
-        UV_ARRAY,
-        2,
-        _gl.FLOAT,
-        false,
-        0,
-        vOffset + numTotalVertexFloats * SIZE_OF_FLOAT
-      );
+      let indexCount = m.indexCount;
+      for (++i; i < meshes.length && !m.needsScissor; ++i) {
+        const next = meshes[i];
+        if (
+          next.needsScissor ||
+          next.image._uniqueID != boundTextureID ||
+          next.atlasBaseVertex != boundBaseVertex
+        ) {
+          break;
+        }
+        indexCount += next.indexCount;
+      }
       _gl.drawElements(
         _gl.TRIANGLES,
-        m.indices.length,
+        indexCount,
         _gl.UNSIGNED_SHORT,
-        iOffset
+        indexOffset * SIZE_OF_U16
       );
-
-      vOffset += m.vtx.length * SIZE_OF_FLOAT;
-      iOffset += m.indices.length * SIZE_OF_U16;
+      indexOffset += indexCount;
     }
-    console.assert(vOffset == numTotalVertexFloats * SIZE_OF_FLOAT);
-    console.assert(iOffset == numTotalIndices * SIZE_OF_U16);
   };
 
   this.canvas = function () {
@@ -311,6 +321,87 @@ const offscreenWebGL = new (function () {
   };
 })();
 
+// Shadows the parts of a canvas 2D context's state that draws write, so writes that wouldn't
+// change anything can be skipped. Context property setters are expensive, and consecutive draws
+// usually share most of their state. Follows the context's save()/restore() stack.
+function CanvasStateCache(ctx) {
+  const _stack = [];
+  let _blend, _alpha, _fillStyle, _strokeStyle, _lineWidth, _lineCap, _lineJoin;
+
+  // Forgets everything, for when the context may have been changed by someone else (or resized).
+  this.reset = function () {
+    _stack.length = 0;
+    _blend = _alpha = _fillStyle = _strokeStyle = undefined;
+    _lineWidth = _lineCap = _lineJoin = undefined;
+  };
+  this.reset();
+
+  this.save = function () {
+    ctx["save"]();
+    _stack.push(
+      _blend,
+      _alpha,
+      _fillStyle,
+      _strokeStyle,
+      _lineWidth,
+      _lineCap,
+      _lineJoin
+    );
+  };
+
+  this.restore = function () {
+    ctx["restore"]();
+    if (_stack.length == 0) {
+      // The matching save() happened before the last reset.
+      this.reset();
+      return;
+    }
+    _lineJoin = _stack.pop();
+    _lineCap = _stack.pop();
+    _lineWidth = _stack.pop();
+    _strokeStyle = _stack.pop();
+    _fillStyle = _stack.pop();
+    _alpha = _stack.pop();
+    _blend = _stack.pop();
+  };
+
+  this.blend = function (value) {
+    if (_blend !== value) {
+      ctx["globalCompositeOperation"] = _blend = value;
+    }
+  };
+  this.alpha = function (value) {
+    if (_alpha !== value) {
+      ctx["globalAlpha"] = _alpha = value;
+    }
+  };
+  this.fillStyle = function (value) {
+    if (_fillStyle !== value) {
+      ctx["fillStyle"] = _fillStyle = value;
+    }
+  };
+  this.strokeStyle = function (value) {
+    if (_strokeStyle !== value) {
+      ctx["strokeStyle"] = _strokeStyle = value;
+    }
+  };
+  this.lineWidth = function (value) {
+    if (_lineWidth !== value) {
+      ctx["lineWidth"] = _lineWidth = value;
+    }
+  };
+  this.lineCap = function (value) {
+    if (_lineCap !== value) {
+      ctx["lineCap"] = _lineCap = value;
+    }
+  };
+  this.lineJoin = function (value) {
+    if (_lineJoin !== value) {
+      ctx["lineJoin"] = _lineJoin = value;
+    }
+  };
+}
+
 Rive.onRuntimeInitialized = function () {
   const RenderPaintStyle = Rive.RenderPaintStyle;
   const FillRule = Rive.FillRule;
@@ -328,12 +419,46 @@ Rive.onRuntimeInitialized = function () {
   const evenOdd = FillRule.evenOdd;
   const nonZero = FillRule.nonZero;
 
+  // Render objects are referred to by handle in the draw command buffer. Handles of deleted
+  // objects are only recycled after the next flush, since recorded commands may still use them.
+  const _renderObjects = [null];
+  const _freeHandles = [];
+  const _releasedHandles = [];
+
+  function registerRenderObject(object) {
+    const handle = _freeHandles.length
+      ? _freeHandles.pop()
+      : _renderObjects.length;
+    _renderObjects[handle] = object;
+    return handle;
+  }
+
+  function releaseRenderObject(handle) {
+    _releasedHandles.push(handle);
+  }
+
+  function recycleReleasedHandles() {
+    for (const handle of _releasedHandles) {
+      _renderObjects[handle] = null;
+      _freeHandles.push(handle);
+    }
+    _releasedHandles.length = 0;
+  }
+
   let _nextImageUniqueID = 1;
   var CanvasRenderImage = RenderImage.extend("CanvasRenderImage", {
     "__construct": function () {
       this["__parent"]["__construct"].call(this);
       this._uniqueID = _nextImageUniqueID;
       _nextImageUniqueID = (_nextImageUniqueID + 1) & 0x7fffffff || 1;
+      this._handle = registerRenderObject(this);
+    },
+    "__destruct": function () {
+      releaseRenderObject(this._handle);
+      this["__parent"]["__destruct"].call(this);
+    },
+    "_getHandle": function () {
+      return this._handle;
     },
     "decode": function (bytes) {
       let context = loadContext;
@@ -398,48 +523,156 @@ Rive.onRuntimeInitialized = function () {
         return "luminosity";
     }
   }
+  // Blend strings by BlendMode value, for draw commands that encode the blend mode as a number.
+  const _canvasBlendByValue = [];
+  for (const key in BlendMode["values"]) {
+    const mode = BlendMode["values"][key];
+    _canvasBlendByValue[mode["value"]] = _canvasBlend(mode);
+  }
   var CanvasRenderPath = RenderPath.extend("CanvasRenderPath", {
     "__construct": function () {
       this["__parent"]["__construct"].call(this);
       this._path2D = new Path2D();
+      this._handle = registerRenderObject(this);
     },
-    "rewind": function () {
-      this._path2D = new Path2D();
-    },
-    "addPath": function (path, xx, xy, yx, yy, tx, ty) {
-      this._path2D["addPath"](path._path2D, makeMatrix(xx, xy, yx, yy, tx, ty));
+    "__destruct": function () {
+      releaseRenderObject(this._handle);
+      this["__parent"]["__destruct"].call(this);
     },
-    "fillRule": function (fillRule) {
-      this._fillRule = fillRule;
+    "_getHandle": function () {
+      return this._handle;
     },
-    "moveTo": function (x, y) {
-      this._path2D["moveTo"](x, y);
-    },
-    "lineTo": function (x, y) {
-      this._path2D["lineTo"](x, y);
-    },
-    "cubicTo": function (ox, oy, ix, iy, x, y) {
-      this._path2D["bezierCurveTo"](ox, oy, ix, iy, x, y);
-    },
-    "close": function () {
-      this._path2D["closePath"]();
+    // Rebuilds the Path2D from views over the path's verbs and points in the WASM heap. Called
+    // from C++ before the path is drawn, whenever its geometry has changed.
+    "_updatePath": function (verbs, points) {
+      const path2D = new Path2D();
+      for (let i = 0, p = 0, l = verbs.length; i < l; i++) {
+        switch (verbs[i]) {
+          case PATH_VERB_MOVE:
+            path2D["moveTo"](points[p], points[p + 1]);
+            p += 2;
+            break;
+          case PATH_VERB_LINE:
+            path2D["lineTo"](points[p], points[p + 1]);
+            p += 2;
+            break;
+          case PATH_VERB_CUBIC:
+            path2D["bezierCurveTo"](
+              points[p],
+              points[p + 1],
+              points[p + 2],
+              points[p + 3],
+              points[p + 4],
+              points[p + 5]
+            );
+            p += 6;
+            break;
+          case PATH_VERB_CLOSE:
+            path2D["closePath"]();
+            break;
+        }
+      }
+      this._path2D = path2D;
     },
   });
 
+  // Interned color strings, so colors that come back around don't rebuild their strings and can
+  // be compared cheaply against the context's current style. Cleared if it grows too large, i.e.
+  // from continuously animating colors.
+  const _colorStyles = new Map();
+  const MAX_COLOR_STYLES = 1024;
   function _colorStyle(value) {
-    return (
-      "rgba(" +
-      ((0x00ff0000 & value) >>> 16) +
-      "," +
-      ((0x0000ff00 & value) >>> 8) +
-      "," +
-      ((0x000000ff & value) >>> 0) +
-      "," +
-      ((0xff000000 & value) >>> 24) / 0xff +
-      ")"
-    );
+    let style = _colorStyles.get(value);
+    if (style === undefined) {
+      if (_colorStyles.size >= MAX_COLOR_STYLES) {
+        _colorStyles.clear();
+      }
+      style =
+        "rgba(" +
+        ((0x00ff0000 & value) >>> 16) +
+        "," +
+        ((0x0000ff00 & value) >>> 8) +
+        "," +
+        ((0x000000ff & value) >>> 0) +
+        "," +
+        ((0xff000000 & value) >>> 24) / 0xff +
+        ")";
+      _colorStyles.set(value, style);
+    }
+    return style;
+  }
+  // Recently used CanvasGradients by the hash of their parameters, from least to most recently
+  // used. Entries keep their parameters so a hash collision can't return the wrong gradient.
+  const _gradientCache = new Map();
+  const MAX_CACHED_GRADIENTS = 256;
+
+  function _sameArray(a, b) {
+    if (a.length != b.length) {
+      return false;
+    }
+    for (let i = 0, l = a.length; i < l; i++) {
+      if (a[i] !== b[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  function _findGradient(params) {
+    const entry = _gradientCache.get(params.key);
+    if (
+      entry === undefined ||
+      entry.isRadial !== params.isRadial ||
+      entry.sx !== params.sx ||
+      entry.sy !== params.sy ||
+      entry.ex !== params.ex ||
+      entry.ey !== params.ey ||
+      !_sameArray(entry.colors, params.colors) ||
+      !_sameArray(entry.stops, params.stops)
+    ) {
+      return null;
+    }
+    // Move the entry to the most recently used end.
+    _gradientCache.delete(params.key);
+    _gradientCache.set(params.key, entry);
+    return entry.canvasGradient;
+  }
+
+  function _cacheGradient(params, canvasGradient) {
+    if (_gradientCache.size >= MAX_CACHED_GRADIENTS) {
+      _gradientCache.delete(_gradientCache.keys().next().value);
+    }
+    params.canvasGradient = canvasGradient;
+    _gradientCache.set(params.key, params);
+  }
+
+  // Points the paint at a cached CanvasGradient if there is one, otherwise holds on to a copy of
+  // the parameters (which are views into WASM memory) to build it at draw time.
+  function _setGradient(paint, key, isRadial, sx, sy, ex, ey, colors, stops) {
+    const params = { key, isRadial, sx, sy, ex, ey, colors, stops };
+    const canvasGradient = _findGradient(params);
+    if (canvasGradient !== null) {
+      paint._value = canvasGradient;
+      paint._gradient = null;
+      return;
+    }
+    params.colors = colors.slice();
+    params.stops = stops.slice();
+    paint._gradient = params;
   }
+
   var CanvasRenderPaint = RenderPaint.extend("CanvasRenderPaint", {
+    "__construct": function () {
+      this["__parent"]["__construct"].call(this);
+      this._handle = registerRenderObject(this);
+    },
+    "__destruct": function () {
+      releaseRenderObject(this._handle);
+      this["__parent"]["__destruct"].call(this);
+    },
+    "_getHandle": function () {
+      return this._handle;
+    },
     "color": function (value) {
       this._value = _colorStyle(value);
     },
@@ -478,30 +711,11 @@ Rive.onRuntimeInitialized = function () {
     "blendMode": function (value) {
       this._blend = _canvasBlend(value);
     },
-    "linearGradient": function (sx, sy, ex, ey) {
-      this._gradient = {
-        sx,
-        sy,
-        ex,
-        ey,
-        stops: [],
-      };
+    "linearGradient": function (key, sx, sy, ex, ey, colors, stops) {
+      _setGradient(this, key, false, sx, sy, ex, ey, colors, stops);
     },
-    "radialGradient": function (sx, sy, ex, ey) {
-      this._gradient = {
-        sx,
-        sy,
-        ex,
-        ey,
-        stops: [],
-        isRadial: true,
-      };
-    },
-    "addStop": function (color, stop) {
-      this._gradient.stops.push({
-        color,
-        stop,
-      });
+    "radialGradient": function (key, sx, sy, ex, ey, colors, stops) {
+      _setGradient(this, key, true, sx, sy, ex, ey, colors, stops);
     },
 
     "completeGradient": function () {},
@@ -509,49 +723,51 @@ Rive.onRuntimeInitialized = function () {
     // path object can mutate before flush(). To work around this, we capture the fill rule at
     // draw time. It's a little awkward having a fill rule here even though we might be a
     // stroke, so we probably want to rework this.
-    "draw": function (ctx, path2D, fillRule) {
+    "draw": function (ctx, state, path2D, fillRule) {
       let _style = this._style;
       let _value = this._value;
       let _gradient = this._gradient;
-      let _blend = this._blend;
 
-      ctx["globalCompositeOperation"] = _blend;
+      state.blend(this._blend);
 
       if (_gradient != null) {
-        const sx = _gradient.sx;
-        const sy = _gradient.sy;
-        const ex = _gradient.ex;
-        const ey = _gradient.ey;
-        const stops = _gradient.stops;
-
-        if (_gradient.isRadial) {
-          var dx = ex - sx;
-          var dy = ey - sy;
-          var radius = Math.sqrt(dx * dx + dy * dy);
-          _value = ctx["createRadialGradient"](sx, sy, 0, sx, sy, radius);
-        } else {
-          _value = ctx["createLinearGradient"](sx, sy, ex, ey);
-        }
+        // Another paint may have built the same gradient since this one was set.
+        _value = _findGradient(_gradient);
+        if (_value === null) {
+          const sx = _gradient.sx;
+          const sy = _gradient.sy;
+          const ex = _gradient.ex;
+          const ey = _gradient.ey;
+          const colors = _gradient.colors;
+          const stops = _gradient.stops;
+
+          if (_gradient.isRadial) {
+            var dx = ex - sx;
+            var dy = ey - sy;
+            var radius = Math.sqrt(dx * dx + dy * dy);
+            _value = ctx["createRadialGradient"](sx, sy, 0, sx, sy, radius);
+          } else {
+            _value = ctx["createLinearGradient"](sx, sy, ex, ey);
+          }
 
-        for (let i = 0, l = stops["length"]; i < l; i++) {
-          const value = stops[i];
-          const stop = value.stop;
-          const color = value.color;
-          _value["addColorStop"](stop, _colorStyle(color));
+          for (let i = 0, l = stops.length; i < l; i++) {
+            _value["addColorStop"](stops[i], _colorStyle(colors[i]));
+          }
+          _cacheGradient(_gradient, _value);
         }
         this._value = _value;
         this._gradient = null;
       }
       switch (_style) {
         case stroke:
-          ctx["strokeStyle"] = _value;
-          ctx["lineWidth"] = this._thickness;
-          ctx["lineCap"] = this._cap;
-          ctx["lineJoin"] = this._join;
+          state.strokeStyle(_value);
+          state.lineWidth(this._thickness);
+          state.lineCap(this._cap);
+          state.lineJoin(this._join);
           ctx["stroke"](path2D);
           break;
         case fill:
-          ctx["fillStyle"] = _value;
+          state.fillStyle(_value);
           ctx["fill"](path2D, fillRule);
           break;
       }
@@ -560,124 +776,324 @@ Rive.onRuntimeInitialized = function () {
 
   const _pendingCanvasRenderers = new Set();
   const INITIAL_ATLAS_SIZE = 512;
+  // Flushes a mesh can go unused before its atlas region is forgotten.
+  const MAX_ATLAS_REGION_AGE = 60;
   let _rectanizer = null;
+  // Atlas regions by the key of the mesh drawn in them. Regions persist across flushes, so meshes
+  // that don't change are only copied out to their canvases. The rectanizer can't free individual
+  // regions, so forgotten regions stay allocated until the atlas is repacked.
+  const _atlasRegions = new Map();
+  // Regions that still need to be drawn into the atlas.
   let _atlasMeshList = [];
-  let _atlasNumTotalVertexFloats = 0;
-  let _atlasNumTotalIndices = 0;
+  let _atlasFrame = 0;
+  let _atlasAllocatedArea = 0;
+  // Set when regions get packed into space that earlier meshes were drawn in, which the next
+  // flush has to clear before drawing, since the atlas canvas preserves its contents. Also set
+  // when resizing the canvas lost its contents.
+  let _atlasNeedsClear = false;
+
+  function resetMeshAtlas() {
+    _atlasRegions.clear();
+    _atlasMeshList = [];
+    _atlasAllocatedArea = 0;
+    _atlasNeedsClear = true;
+    _rectanizer["reset"](INITIAL_ATLAS_SIZE, INITIAL_ATLAS_SIZE);
+  }
 
-  function flushCanvasRenderers() {
-    // Draw the mesh atlas before flushing the queued up draws to canvases.
+  // Packs the regions used since the last flush into a fresh atlas and queues them all to be
+  // drawn again. Pending copies out of the atlas read their region's new location.
+  function repackMeshAtlas() {
+    const liveRegions = [];
+    for (const region of _atlasRegions.values()) {
+      if (region.lastUsedFrame == _atlasFrame) {
+        liveRegions.push(region);
+      }
+    }
+    resetMeshAtlas();
+    for (const region of liveRegions) {
+      const pos = _rectanizer["addRect"](
+        region.widthInAtlas,
+        region.heightInAtlas
+      );
+      // These all fit in the atlas before, alongside the stale regions.
+      console.assert(pos >= 0);
+      region.atlasX = pos & 0xffff;
+      region.atlasY = pos >> 16;
+      _atlasRegions.set(region.key, region);
+      _atlasAllocatedArea += region.widthInAtlas * region.heightInAtlas;
+    }
+    _atlasMeshList = liveRegions;
+  }
+
+  // 'keepMeshStaging' is set when flushing in the middle of recording a mesh, whose data is
+  // already staged.
+  function flushCanvasRenderers(keepMeshStaging) {
+    if (_rectanizer) {
+      let liveArea = 0;
+      for (const region of _atlasRegions.values()) {
+        if (region.lastUsedFrame == _atlasFrame) {
+          liveArea += region.widthInAtlas * region.heightInAtlas;
+        }
+      }
+      // Repack once most of the atlas is taken up by regions that are no longer in use. This
+      // happens even if there are no new meshes, so the atlas can shrink after a burst of them.
+      if (
+        _atlasAllocatedArea > INITIAL_ATLAS_SIZE * INITIAL_ATLAS_SIZE &&
+        liveArea < _atlasAllocatedArea / 2
+      ) {
+        repackMeshAtlas();
+      }
+      if (
+        offscreenWebGL.resizeAtlas(
+          _rectanizer["drawWidth"](),
+          _rectanizer["drawHeight"]()
+        )
+      ) {
+        // Resizing the canvas lost its contents.
+        if (!_atlasNeedsClear) {
+          repackMeshAtlas();
+          offscreenWebGL.resizeAtlas(
+            _rectanizer["drawWidth"](),
+            _rectanizer["drawHeight"]()
+          );
+        }
+        _atlasNeedsClear = true;
+      }
+    }
+    // Draw new meshes into the atlas before flushing the queued up draws to canvases.
     if (_atlasMeshList.length > 0) {
+      // Sort the meshes into a draw order that minimizes the cost of GL state changes.
+      _atlasMeshList.sort((a, b) => b.sortKey - a.sortKey);
+      Module["_beginMeshAtlas"]();
+      for (const m of _atlasMeshList) {
+        // Pretransform the mesh so its top-left corner lands at (atlasX, atlasY) in the atlas,
+        // scaled by (scaleX, scaleY).
+        m.atlasBaseVertex = Module["_addAtlasMesh"](
+          m.firstVertex,
+          m.vertexCount,
+          m.baseVertex,
+          m.indexOffset,
+          m.indexCount,
+          m.mat[0] * m.scaleX,
+          m.mat[1] * m.scaleY,
+          m.mat[2] * m.scaleX,
+          m.mat[3] * m.scaleY,
+          (m.mat[4] - m.meshX) * m.scaleX + m.atlasX,
+          (m.mat[5] - m.meshY) * m.scaleY + m.atlasY
+        );
+      }
       offscreenWebGL.drawMeshAtlas(
-        _rectanizer["drawWidth"](),
-        _rectanizer["drawHeight"](),
         _atlasMeshList,
-        _atlasNumTotalVertexFloats,
-        _atlasNumTotalIndices
+        {
+          vertices: Module["_meshAtlasVertices"](),
+          uvs: Module["_meshAtlasUVs"](),
+          indices: Module["_meshAtlasIndices"](),
+        },
+        _atlasNeedsClear
       );
+      _atlasNeedsClear = false;
       _atlasMeshList = [];
-      _atlasNumTotalVertexFloats = 0;
-      _atlasNumTotalIndices = 0;
-      _rectanizer["reset"](INITIAL_ATLAS_SIZE, INITIAL_ATLAS_SIZE);
     }
+    if (!keepMeshStaging) {
+      Module["_resetMeshStaging"]();
+    }
+    // Forget regions that haven't been used in a while.
+    for (const region of _atlasRegions.values()) {
+      if (_atlasFrame - region.lastUsedFrame > MAX_ATLAS_REGION_AGE) {
+        _atlasRegions.delete(region.key);
+      }
+    }
+    ++_atlasFrame;
     // Now that the atlas is rendered, make the pending draws to canvases, some of which may
     // reference the atlas.
     for (const renderer of _pendingCanvasRenderers) {
-      for (const lambda of renderer._drawList) {
-        lambda();
+      // When the atlas overflowed in the middle of recording, the frame isn't done yet. Its
+      // clear stays a full one.
+      if (!keepMeshStaging) {
+        renderer["_finishFrame"]();
       }
-      renderer._drawList = [];
+      replayDrawCommands(renderer);
     }
     _pendingCanvasRenderers.clear();
+    recycleReleasedHandles();
+  }
+
+  // Replays the draw commands a renderer recorded in WASM memory onto its canvas.
+  function replayDrawCommands(renderer) {
+    const words = renderer["_commands"]();
+    const floats = new Float32Array(
+      words.buffer,
+      words.byteOffset,
+      words.length
+    );
+    const ctx = renderer._ctx;
+    const state = renderer._state;
+    state.reset();
+    const evenOddValue = evenOdd["value"];
+    // Set while the current frame is clipped to the area that changed.
+    let clipped = false;
+    for (let i = 0, l = words.length; i < l; ) {
+      switch (words[i++]) {
+        case CMD_SAVE:
+          state.save();
+          break;
+        case CMD_RESTORE:
+          state.restore();
+          break;
+        case CMD_SET_TRANSFORM:
+          ctx["setTransform"](
+            floats[i],
+            floats[i + 1],
+            floats[i + 2],
+            floats[i + 3],
+            floats[i + 4],
+            floats[i + 5]
+          );
+          i += 6;
+          break;
+        case CMD_DRAW_PATH: {
+          const path = _renderObjects[words[i]];
+          const paint = _renderObjects[words[i + 1]];
+          const fillRule =
+            words[i + 2] === evenOddValue ? "evenodd" : "nonzero";
+          paint["draw"](ctx, state, path._path2D, fillRule);
+          i += 3;
+          break;
+        }
+        case CMD_CLIP_PATH: {
+          const path = _renderObjects[words[i]];
+          const fillRule =
+            words[i + 1] === evenOddValue ? "evenodd" : "nonzero";
+          ctx["clip"](path._path2D, fillRule);
+          i += 2;
+          break;
+        }
+        case CMD_DRAW_IMAGE: {
+          const img = _renderObjects[words[i]]._image;
+          if (img) {
+            state.blend(_canvasBlendByValue[words[i + 1]]);
+            state.alpha(floats[i + 2]);
+            ctx["drawImage"](img, 0, 0);
+            state.alpha(1);
+          }
+          i += 3;
+          break;
+        }
+        case CMD_CLEAR: {
+          if (clipped) {
+            state.restore();
+            clipped = false;
+          }
+          // Only the area (l, t, r, b) changed since the last frame. Everywhere else, the canvas
+          // still has the right pixels.
+          const l = floats[i];
+          const t = floats[i + 1];
+          const r = floats[i + 2];
+          const b = floats[i + 3];
+          if (l >= r || t >= b) {
+            // Nothing changed; skip the whole frame.
+            i = words[i + 4];
+            break;
+          }
+          i += 5;
+          ctx["resetTransform"]();
+          if (
+            l > 0 ||
+            t > 0 ||
+            r < renderer._canvas["width"] ||
+            b < renderer._canvas["height"]
+          ) {
+            state.save();
+            clipped = true;
+            ctx["beginPath"]();
+            ctx["rect"](l, t, r - l, b - t);
+            ctx["clip"]();
+          }
+          ctx["clearRect"](l, t, r - l, b - t);
+          break;
+        }
+        case CMD_DRAW_DEFERRED:
+          renderer._deferredDraws[words[i++]]();
+          break;
+      }
+    }
+    if (clipped) {
+      state.restore();
+    }
+    renderer["_resetCommands"]();
+    renderer._deferredDraws = [];
+    // Remember the canvas the frame was drawn into, so the next frame can tell if it was lost.
+    renderer._frameWidth = renderer._canvas["width"];
+    renderer._frameHeight = renderer._canvas["height"];
+    ctx["lineDashOffset"] = FRAME_MARK_DASH_OFFSET;
   }
 
   var CanvasRenderer = (Rive.CanvasRenderer = Renderer.extend("Renderer", {
     "__construct": function (canvas) {
       this["__parent"]["__construct"].call(this);
-      // Keep a local shadow of the matrix stack, since actual calls to the canvas2d context
-      // are deferred, but we reed this matrix data at record time.
-      this._matrixStack = [1, 0, 0, 1, 0, 0];
       this._ctx = canvas["getContext"]("2d");
+      this._state = new CanvasStateCache(this._ctx);
       this._canvas = canvas;
-      this._drawList = [];
-    },
-    "save": function () {
-      const i = this._matrixStack.length - 6;
-      this._matrixStack.push(...this._matrixStack.slice(i));
-      this._drawList.push(this._ctx["save"].bind(this._ctx));
-    },
-    "restore": function () {
-      const i = this._matrixStack.length - 6;
-      if (i < 6) {
-        throw "restore() called without matching save().";
-      }
-      this._matrixStack.splice(i); // Pop off the top 6 floats from the matrix stack.
-      this._drawList.push(this._ctx["restore"].bind(this._ctx));
-    },
-    "transform": function (xx, xy, yx, yy, tx, ty) {
-      const S = this._matrixStack;
-      const i = S.length - 6;
-      //            |S0  S2  S4|   |xx  yx  tx|
-      // S.back() = |S1  S3  S5| * |xy  yy  ty|
-      //            | 0   0   1|   | 0   0   1|
-      S.splice(
-        i,
-        6,
-        S[i + 0] * xx + S[i + 2] * xy,
-        S[i + 1] * xx + S[i + 3] * xy,
-        S[i + 0] * yx + S[i + 2] * yy,
-        S[i + 1] * yx + S[i + 3] * yy,
-        S[i + 0] * tx + S[i + 2] * ty + S[i + 4],
-        S[i + 1] * tx + S[i + 3] * ty + S[i + 5]
-      );
-      this._drawList.push(
-        this._ctx["transform"].bind(this._ctx, xx, xy, yx, yy, tx, ty)
-      );
+      // Draws that can't be encoded in the command buffer, i.e. copying meshes out of the atlas.
+      this._deferredDraws = [];
     },
     "rotate": function (angle) {
       const sin = Math.sin(angle);
       const cos = Math.cos(angle);
-      this.transform(cos, sin, -sin, cos, 0, 0);
-    },
-    "_drawPath": function (path, paint) {
-      const fillRule = path._fillRule === evenOdd ? "evenodd" : "nonzero";
-      this._drawList.push(
-        paint["draw"].bind(paint, this._ctx, path._path2D, fillRule)
-      );
-    },
-    "_drawImage": function (image, blend, opacity) {
-      var img = image._image;
-      if (!img) {
-        return;
-      }
-      var ctx = this._ctx;
-      const canvasBlend = _canvasBlend(blend);
-      this._drawList.push(function () {
-        ctx["globalCompositeOperation"] = canvasBlend;
-        ctx["globalAlpha"] = opacity;
-        ctx["drawImage"](img, 0, 0);
-        ctx["globalAlpha"] = 1;
-      });
-    },
-    "_getMatrix": function (out) {
-      const S = this._matrixStack;
-      const i = S.length - 6;
-      for (let j = 0; j < 6; ++j) {
-        out[j] = S[i + j];
-      }
+      this["_transform"](cos, sin, -sin, cos, 0, 0);
     },
     "_drawImageMesh": function (
       image,
       blend,
       opacity,
-      vtx,
-      uv,
-      indices,
+      mat,
       meshMinX,
       meshMinY,
       meshMaxX,
-      meshMaxY
+      meshMaxY,
+      lodScale,
+      key,
+      firstVertex,
+      vertexCount,
+      baseVertex,
+      indexOffset,
+      indexCount
     ) {
+      const ctx = this._ctx;
+      const canvasBlend = _canvasBlend(blend);
+      // Blits the mesh from its region of the atlas, wherever that is by the time this runs.
+      const blit = function (region) {
+        ctx["save"]();
+        ctx["resetTransform"]();
+        ctx["globalCompositeOperation"] = canvasBlend;
+        ctx["globalAlpha"] = opacity;
+        ctx["drawImage"](
+          offscreenWebGL.canvas(),
+          region.atlasX,
+          region.atlasY,
+          region.widthInAtlas,
+          region.heightInAtlas,
+          region.meshX,
+          region.meshY,
+          region.meshClippedWidth,
+          region.meshClippedHeight
+        );
+        ctx["restore"]();
+      };
+
+      // The key covers everything that affects how the mesh is rasterized, so if it's already
+      // in the atlas it only needs to be copied out again.
+      let region = _atlasRegions.get(key);
+      if (region !== undefined) {
+        region.lastUsedFrame = _atlasFrame;
+        // Keep track of where the mesh is staged this frame, in case the atlas is repacked.
+        region.firstVertex = firstVertex;
+        region.baseVertex = baseVertex;
+        region.indexOffset = indexOffset;
+        this._deferredDraws.push(blit.bind(null, region));
+        return this._deferredDraws.length - 1;
+      }
+
       const canvasWidth = this._ctx["canvas"]["width"];
       const canvasHeight = this._ctx["canvas"]["height"];
       const meshWidth = meshMaxX - meshMinX;
@@ -694,16 +1110,18 @@ Rive.onRuntimeInitialized = function () {
       console.assert(meshClippedHeight <= Math.min(meshHeight, canvasHeight));
       // Bail if the bounding box was out of view.
       if (meshClippedWidth <= 0 || meshClippedHeight <= 0) {
-        return;
+        return -1;
       }
       const needsScissor =
         meshClippedWidth < meshWidth || meshClippedHeight < meshHeight;
 
-      // TODO: downscale the mesh in the atlas when it is larger than the underlying texture.
-      let scaleX = 1;
-      let scaleY = 1;
-      let widthInAtlas = Math.ceil(meshClippedWidth * scaleX);
-      let heightInAtlas = Math.ceil(meshClippedHeight * scaleY);
+      // Don't rasterize the mesh at a higher resolution than its texture. The canvas scales it
+      // back up when it copies it out of the atlas, so scale by exactly the rounded size in the
+      // atlas to keep the copy from stretching it.
+      let widthInAtlas = Math.max(Math.ceil(meshClippedWidth * lodScale), 1);
+      let heightInAtlas = Math.max(Math.ceil(meshClippedHeight * lodScale), 1);
+      let scaleX = widthInAtlas / meshClippedWidth;
+      let scaleY = heightInAtlas / meshClippedHeight;
 
       // Don't draw larger than the max render target size.
       const maxRTSize = offscreenWebGL.maxRTSize();
@@ -723,83 +1141,68 @@ Rive.onRuntimeInitialized = function () {
       }
       let pos = _rectanizer["addRect"](widthInAtlas, heightInAtlas);
       if (pos < 0) {
-        // The atlas ran out of room. Flush and try again.
-        flushCanvasRenderers();
+        // The atlas ran out of room. Flush, start over with an empty atlas, and try again.
+        flushCanvasRenderers(true /*keepMeshStaging*/);
         _pendingCanvasRenderers.add(this);
+        resetMeshAtlas();
         pos = _rectanizer["addRect"](widthInAtlas, heightInAtlas);
         // The atlas should always be big enough to fit at least one canvas.
         console.assert(pos >= 0);
       }
-      const atlasX = pos & 0xffff;
-      const atlasY = pos >> 16;
 
-      _atlasMeshList.push({
-        mat: this._matrixStack.slice(this._matrixStack.length - 6),
+      region = {
+        key: key,
+        lastUsedFrame: _atlasFrame,
+        mat: new Float32Array(mat),
         image: image,
-        atlasX: atlasX,
-        atlasY: atlasY,
+        atlasX: pos & 0xffff,
+        atlasY: pos >> 16,
         meshX: meshMinX,
         meshY: meshMinY,
+        meshClippedWidth: meshClippedWidth,
+        meshClippedHeight: meshClippedHeight,
         widthInAtlas: widthInAtlas,
         heightInAtlas: heightInAtlas,
         scaleX: scaleX,
         scaleY: scaleY,
-        vtx: new Float32Array(vtx),
-        uv: new Float32Array(uv),
-        indices: new Uint16Array(indices),
+        firstVertex: firstVertex,
+        vertexCount: vertexCount,
+        baseVertex: baseVertex,
+        indexOffset: indexOffset,
+        indexCount: indexCount,
+        atlasBaseVertex: 0,
         needsScissor: needsScissor,
         // Create a sortKey with more expensive state in higher order bits.
         // This will produce an ordering that minimizes the cost of GL
         // state changes.
         sortKey: (image._uniqueID << 1) | (needsScissor ? 1 : 0),
-      });
-      _atlasNumTotalVertexFloats += vtx.length;
-      _atlasNumTotalIndices += indices.length;
+      };
+      _atlasRegions.set(key, region);
+      _atlasMeshList.push(region);
+      _atlasAllocatedArea += widthInAtlas * heightInAtlas;
 
-      const ctx = this._ctx;
-      const canvasBlend = _canvasBlend(blend);
-      this._drawList.push(function () {
-        ctx["save"]();
-        ctx["resetTransform"]();
-        ctx["globalCompositeOperation"] = canvasBlend;
-        ctx["globalAlpha"] = opacity;
-        ctx["drawImage"](
-          offscreenWebGL.canvas(),
-          atlasX,
-          atlasY,
-          widthInAtlas,
-          heightInAtlas,
-          meshMinX,
-          meshMinY,
-          meshClippedWidth,
-          meshClippedHeight
-        );
-        ctx["restore"]();
-      });
-    },
-    "_clipPath": function (path) {
-      const fillRule = path._fillRule === evenOdd ? "evenodd" : "nonzero";
-      this._drawList.push(
-        this._ctx["clip"].bind(this._ctx, path._path2D, fillRule)
-      );
+      this._deferredDraws.push(blit.bind(null, region));
+      return this._deferredDraws.length - 1;
     },
     "clear": function () {
       // Add ourselves to the list of deferred canvases. This works here because clear aways
       // gets called first.
       _pendingCanvasRenderers.add(this);
-      this._drawList.push(
-        this._ctx["clearRect"].bind(
-          this._ctx,
-          0,
-          0,
-          this._canvas["width"],
-          this._canvas["height"]
-        )
-      );
+      // Only the parts of the frame that changed get redrawn, which relies on the canvas still
+      // holding the last frame. Redraw everything if it has been resized or reset since.
+      const canvas = this._canvas;
+      if (
+        canvas["width"] !== this._frameWidth ||
+        canvas["height"] !== this._frameHeight ||
+        this._ctx["lineDashOffset"] !== FRAME_MARK_DASH_OFFSET
+      ) {
+        this["invalidate"]();
+      }
+      this["_clear"](canvas["width"], canvas["height"]);
     },
     "flush": function () {},
     "translate": function (x, y) {
-      this.transform(1, 0, 0, 1, x, y);
+      this["_transform"](1, 0, 0, 1, x, y);
     },
   }));
 
@@ -819,9 +1222,10 @@ Rive.onRuntimeInitialized = function () {
     },
   };
 
-  let load = Rive["load"];
   let loadContext = null;
-  Rive["load"] = function (bytes) {
+  // Wraps a synchronous wasm file loader in a Promise that resolves once all of the file's
+  // images have finished decoding.
+  function promiseLoad(load) {
     return new Promise(function (resolve, reject) {
       let result = null;
       loadContext = {
@@ -831,11 +1235,25 @@ Rive.onRuntimeInitialized = function () {
           resolve(result);
         },
       };
-      result = load(bytes);
+      result = load();
       if (loadContext.total == 0) {
         resolve(result);
       }
     });
+  }
+
+  let load = Rive["load"];
+  Rive["load"] = function (bytes) {
+    return promiseLoad(function () {
+      return load(bytes);
+    });
+  };
+
+  let loadFromBuffer = Rive["loadFromBuffer"];
+  Rive["loadFromBuffer"] = function (buffer, retain) {
+    return promiseLoad(function () {
+      return loadFromBuffer(buffer, !!retain);
+    });
   };
 
   const _animationCallbackHandler = new AnimationCallbackHandler();
@@ -843,6 +1261,10 @@ Rive.onRuntimeInitialized = function () {
     _animationCallbackHandler.requestAnimationFrame.bind(
       _animationCallbackHandler
     );
+  Rive["requestPreAnimationFrame"] =
+    _animationCallbackHandler.requestPreAnimationFrame.bind(
+      _animationCallbackHandler
+    );
   Rive["cancelAnimationFrame"] =
     _animationCallbackHandler.cancelAnimationFrame.bind(
       _animationCallbackHandler
@@ -298,6 +298,11 @@ Module.onRuntimeInitialized = function () {
     return Promise.resolve(load(bytes));
   };
 
+  let loadFromBuffer = Rive["loadFromBuffer"];
+  Rive["loadFromBuffer"] = function (buffer, retain) {
+    return Promise.resolve(loadFromBuffer(buffer, !!retain));
+  };
+
   const cppClear = Module["WebGLRenderer"]["prototype"]["clear"];
   Module["WebGLRenderer"]["prototype"]["clear"] = function () {
     // Resize Skia surface if the canvas size changed.
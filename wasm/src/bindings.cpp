@@ -9,6 +9,7 @@
 #include "rive/animation/state_machine_bool.hpp"
 #include "rive/animation/state_machine_input_instance.hpp"
 #include "rive/animation/state_machine_instance.hpp"
+#include "rive/animation/state_machine_listener.hpp"
 #include "rive/animation/state_machine_number.hpp"
 #include "rive/animation/state_machine_trigger.hpp"
 #include "rive/artboard.hpp"
@@ -26,6 +27,8 @@
 #include "rive/renderer.hpp"
 #include "rive/shapes/cubic_vertex.hpp"
 #include "rive/shapes/path.hpp"
+#include "rive/shapes/path_vertex.hpp"
+#include "rive/shapes/shape.hpp"
 #include "rive/transform_component.hpp"
 
 #include "js_alignment.hpp"
@@ -38,7 +41,13 @@
 #include <emscripten/val.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <sanitizer/lsan_interface.h>
 
@@ -69,6 +78,89 @@ rive::File* load(emscripten::val byteArray)
     return rive::File::import(rv, jsFactory()).release();
 }
 
+// A block of wasm heap memory that JS can write a .riv into directly (e.g. straight out of a
+// fetch), so the bytes don't first have to be copied into a temporary vector for the importer.
+// The buffer can either be sized up front, or grown a chunk at a time with append() as the file
+// streams in over the network.
+class FileBuffer
+{
+public:
+    FileBuffer(size_t size) : m_Bytes(new uint8_t[size]), m_Size(size), m_Capacity(size) {}
+
+    // Returns a Uint8Array view of the buffer for JS to write into. The view is invalidated if
+    // the wasm heap grows, so fetch a fresh one after anything that may allocate.
+    emscripten::val bytes()
+    {
+        return emscripten::val(emscripten::typed_memory_view(m_Size, m_Bytes.get()));
+    }
+
+    size_t size() const { return m_Size; }
+
+    // Makes room for the buffer to grow to 'capacity' bytes without reallocating, e.g. when the
+    // expected length of a download is known.
+    void reserve(size_t capacity)
+    {
+        if (capacity <= m_Capacity)
+        {
+            return;
+        }
+        std::unique_ptr<uint8_t[]> bytes(new uint8_t[capacity]);
+        if (m_Size > 0)
+        {
+            memcpy(bytes.get(), m_Bytes.get(), m_Size);
+        }
+        m_Bytes = std::move(bytes);
+        m_Capacity = capacity;
+    }
+
+    // Copies a chunk of bytes (any typed array) from JS onto the end of the buffer.
+    void append(emscripten::val chunk)
+    {
+        const auto length = chunk["byteLength"].as<size_t>();
+        if (m_Size + length > m_Capacity)
+        {
+            // Grow geometrically so a file streamed in many small chunks is only copied
+            // internally a logarithmic number of times.
+            reserve(std::max(m_Size + length, m_Capacity * 2));
+        }
+        emscripten::val memoryView{
+            emscripten::typed_memory_view(length, m_Bytes.get() + m_Size)};
+        memoryView.call<void>("set", chunk);
+        m_Size += length;
+    }
+
+    // Frees the bytes while keeping the (now empty) buffer object around.
+    void release()
+    {
+        m_Bytes.reset();
+        m_Size = m_Capacity = 0;
+    }
+
+    rive::Span<const uint8_t> span() const { return {m_Bytes.get(), m_Size}; }
+
+private:
+    std::unique_ptr<uint8_t[]> m_Bytes;
+    size_t m_Size;
+    size_t m_Capacity;
+};
+
+// Imports a file from a FileBuffer without copying it. The importer doesn't need the bytes once
+// it's done, so unless the caller asks to retain them (e.g. to import the same bytes again
+// later), the buffer's memory is released right away.
+//
+// Only the download streams. The import itself is still a single blocking pass over the whole
+// buffer, since rive::File::import can't be paused and resumed partway through a file; parsing
+// objects as chunks arrive, and yielding between them, needs a resumable importer in rive-cpp.
+rive::File* loadFromBuffer(FileBuffer* buffer, bool retain)
+{
+    auto file = rive::File::import(buffer->span(), jsFactory());
+    if (!retain)
+    {
+        buffer->release();
+    }
+    return file.release();
+}
+
 rive::Alignment convertAlignment(JsAlignment alignment)
 {
     switch (alignment)
@@ -105,12 +197,11 @@ rive::Vec2D mapXY(rive::Mat2D invertedMatrix, rive::Vec2D canvasVector)
     return invertedMatrix * canvasVector;
 }
 
-bool hasListeners(rive::StateMachineInstance* smi)
+bool hasListeners(rive::StateMachineInstance* smi);
+
+// Whether a state machine in one of the artboard's nested artboards has listeners.
+static bool hasNestedListeners(rive::StateMachineInstance* smi)
 {
-    if (smi->stateMachine()->listenerCount() != 0)
-    {
-        return true;
-    }
     for (auto nestedArtboard : smi->artboard()->nestedArtboards())
     {
         for (auto animation : nestedArtboard->nestedAnimations())
@@ -128,6 +219,671 @@ bool hasListeners(rive::StateMachineInstance* smi)
     return false;
 }
 
+bool hasListeners(rive::StateMachineInstance* smi)
+{
+    return smi->stateMachine()->listenerCount() != 0 || hasNestedListeners(smi);
+}
+
+// Passes pointer events on to a state machine, skipping its per-shape hit testing for moves that
+// can't reach any of its listeners' shapes. A move is skipped when it's outside the bounds of
+// every shape a listener targets, and so was the last event passed on, which means no shape is
+// hovered that the move could leave. Bounds are taken from the paths' vertices and control
+// points at the time of each move, so they follow the shapes as they animate.
+//
+// State machines whose listeners can't be bounded this way, i.e. ones with listeners in nested
+// artboards, get every move. Holds on to the state machine instance, so it must be deleted first.
+class ListenerBounds
+{
+public:
+    ListenerBounds(rive::StateMachineInstance* smi) : m_Instance(smi)
+    {
+        auto artboard = smi->artboard();
+        auto stateMachine = smi->stateMachine();
+        m_CanCull = !hasNestedListeners(smi);
+        for (size_t i = 0; m_CanCull && i < stateMachine->listenerCount(); ++i)
+        {
+            auto target = artboard->resolve(stateMachine->listener(i)->targetId());
+            if (target == nullptr || !target->is<rive::Component>())
+            {
+                m_CanCull = false;
+                break;
+            }
+            // A listener hit tests every shape at or under its target.
+            for (auto object : artboard->objects())
+            {
+                if (object != nullptr && object->is<rive::Shape>() &&
+                    isWithin(object->as<rive::Component>(), target->as<rive::Component>()))
+                {
+                    m_Shapes.push_back(object->as<rive::Shape>());
+                }
+            }
+        }
+        std::sort(m_Shapes.begin(), m_Shapes.end());
+        m_Shapes.erase(std::unique(m_Shapes.begin(), m_Shapes.end()), m_Shapes.end());
+    }
+
+    // Returns true if the move was passed on to the state machine.
+    bool pointerMove(float x, float y)
+    {
+        bool inside = !m_CanCull || mayHit(x, y);
+        if (!inside && !m_LastInside)
+        {
+            return false;
+        }
+        m_LastInside = inside;
+        m_Instance->pointerMove(rive::Vec2D(x, y));
+        return true;
+    }
+
+    // Downs and ups are always passed on. They update which shapes are hovered too, so the next
+    // move is passed on regardless.
+    void pointerDown(float x, float y)
+    {
+        m_LastInside = true;
+        m_Instance->pointerDown(rive::Vec2D(x, y));
+    }
+    void pointerUp(float x, float y)
+    {
+        m_LastInside = true;
+        m_Instance->pointerUp(rive::Vec2D(x, y));
+    }
+
+private:
+    // Hit testing is done with a small area around the pointer, rather than a single point.
+    static constexpr float kHitMargin = 2;
+
+    static bool isWithin(const rive::Component* component, const rive::Component* ancestor)
+    {
+        for (; component != nullptr; component = component->parent())
+        {
+            if (component == ancestor)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Whether a point in artboard space is within the bounds of any listener's shape.
+    bool mayHit(float x, float y) const
+    {
+        // Shapes are positioned relative to the artboard's origin.
+        auto artboard = m_Instance->artboard();
+        rive::Vec2D point(x - artboard->originX() * artboard->width(),
+                          y - artboard->originY() * artboard->height());
+        for (auto shape : m_Shapes)
+        {
+            for (auto path : shape->paths())
+            {
+                if (pathMayHit(path, point))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static bool pathMayHit(const rive::Path* path, rive::Vec2D point)
+    {
+        const auto& vertices = path->vertices();
+        if (vertices.empty())
+        {
+            return false;
+        }
+        // A path's curves stay within the hull of its vertices and control points.
+        float l = INFINITY, t = INFINITY, r = -INFINITY, b = -INFINITY;
+        auto add = [&](rive::Vec2D p) {
+            l = std::min(l, p.x);
+            t = std::min(t, p.y);
+            r = std::max(r, p.x);
+            b = std::max(b, p.y);
+        };
+        const rive::Mat2D& transform = path->pathTransform();
+        for (auto vertex : vertices)
+        {
+            add(transform * vertex->renderTranslation());
+            if (vertex->is<rive::CubicVertex>())
+            {
+                add(transform * vertex->as<rive::CubicVertex>()->renderIn());
+                add(transform * vertex->as<rive::CubicVertex>()->renderOut());
+            }
+        }
+        return point.x >= l - kHitMargin && point.x <= r + kHitMargin &&
+               point.y >= t - kHitMargin && point.y <= b + kHitMargin;
+    }
+
+    rive::StateMachineInstance* m_Instance;
+    std::vector<rive::Shape*> m_Shapes;
+    bool m_CanCull = true;
+    // Whether the last event passed on could have left a shape hovered.
+    bool m_LastInside = true;
+};
+
+// Sets the state machine input at 'index' from a number: number inputs take the value as is,
+// booleans are set to whether it's nonzero, and triggers fire if it's nonzero. Returns false if
+// there's no such input.
+static bool setInputValue(rive::StateMachineInstance* smi, size_t index, float value)
+{
+    if (index >= smi->inputCount())
+    {
+        return false;
+    }
+    rive::SMIInput* input = smi->input(index);
+    switch (input->inputCoreType())
+    {
+        case stateMachineNumberTypeKey:
+            static_cast<rive::SMINumber*>(input)->value(value);
+            break;
+        case stateMachineBoolTypeKey:
+            static_cast<rive::SMIBool*>(input)->value(value != 0);
+            break;
+        case stateMachineTriggerTypeKey:
+            if (value != 0)
+            {
+                static_cast<rive::SMITrigger*>(input)->fire();
+            }
+            break;
+    }
+    return true;
+}
+
+// Returns the index of the named input, which serves as its handle for setInputs() and
+// StateMachineInputSlots, or -1 if the state machine has no such input.
+static int inputIndex(rive::StateMachineInstance& smi, const std::string& name)
+{
+    for (size_t i = 0; i < smi.inputCount(); ++i)
+    {
+        if (smi.input(i)->name() == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// One float per state machine input, in wasm memory, that JS writes values into directly rather
+// than going through an SMIInput object for every change. Values mean the same as they do for
+// setInputValue(). apply() passes slots that JS wrote since the last apply() on to their inputs
+// wherever they differ from the inputs' current values, and puts fired trigger slots back to 0.
+// Slots JS didn't write pick up the inputs' current values instead, so inputs set some other way
+// aren't overwritten, and writing a slot back to its old value afterwards still takes effect.
+// NaN isn't a valid value; a slot set to NaN is put back to its input's value. Apply before
+// advancing the state machine.
+//
+// Holds on to the state machine instance, so it must be deleted first.
+class StateMachineInputSlots
+{
+public:
+    StateMachineInputSlots(rive::StateMachineInstance* smi) :
+        m_Instance(smi), m_Slots(smi->inputCount()), m_Applied(smi->inputCount())
+    {
+        for (size_t i = 0; i < m_Slots.size(); ++i)
+        {
+            m_Slots[i] = inputValue(i);
+        }
+        m_Applied = m_Slots;
+    }
+
+    // Returns a Float32Array view of the slots, indexed by input. The view is invalidated if the
+    // wasm heap grows, so fetch a fresh one after anything that may allocate.
+    emscripten::val values()
+    {
+        return emscripten::val(emscripten::typed_memory_view(m_Slots.size(), m_Slots.data()));
+    }
+
+    // Returns true if any input changed.
+    bool apply()
+    {
+        bool changed = false;
+        for (size_t i = 0; i < m_Slots.size(); ++i)
+        {
+            float value = m_Slots[i];
+            if (value != m_Applied[i] && !std::isnan(value))
+            {
+                if (m_Instance->input(i)->inputCoreType() == stateMachineBoolTypeKey)
+                {
+                    value = value != 0 ? 1 : 0;
+                }
+                if (value != inputValue(i))
+                {
+                    setInputValue(m_Instance, i, value);
+                    changed = true;
+                }
+            }
+            // Triggers are done with once fired; everything else keeps the value it now has.
+            m_Slots[i] = inputValue(i);
+            m_Applied[i] = m_Slots[i];
+        }
+        return changed;
+    }
+
+private:
+    // The input's current value as a slot value; triggers are always 0.
+    float inputValue(size_t index) const
+    {
+        rive::SMIInput* input = m_Instance->input(index);
+        switch (input->inputCoreType())
+        {
+            case stateMachineNumberTypeKey:
+                return static_cast<rive::SMINumber*>(input)->value();
+            case stateMachineBoolTypeKey:
+                return static_cast<rive::SMIBool*>(input)->value() ? 1 : 0;
+        }
+        return 0;
+    }
+
+    rive::StateMachineInstance* m_Instance;
+    std::vector<float> m_Slots;
+    std::vector<float> m_Applied; // What the slots held after the last apply().
+};
+
+// The name a state change is reported under: the animation's name for animation states.
+static std::string layerStateName(const rive::LayerState* state)
+{
+    if (state != nullptr)
+        switch (state->coreType())
+        {
+            case rive::AnimationState::typeKey:
+                return state->as<rive::AnimationState>()->animation()->name();
+            case rive::EntryState::typeKey:
+                return "entry";
+            case rive::ExitState::typeKey:
+                return "exit";
+            case rive::AnyState::typeKey:
+                return "any";
+        }
+    return "unknown";
+}
+
+// Records what happens while animations and state machines advance (state changes and loops) as
+// fixed-size records in wasm memory, so JS can read a frame's worth in one pass instead of
+// polling every instance after every advance. Each record is four uint32s:
+//
+//   type   - EventQueue::stateChange, EventQueue::loop or EventQueue::overflow
+//   tag    - whatever the caller passed in to identify the instance that advanced
+//   nameId - for state changes, the state's name interned into the queue's name table
+//   count  - for overflows, how many records were dropped; otherwise 0
+//
+// Records go into a fixed ring of kMaxRecords, written at the tail and drained from the head, so
+// recording never allocates. Only a reader that stopped draining fills it up. Records past that
+// are dropped, and the next drain starts with an overflow record saying how many, so nothing goes
+// missing silently.
+class EventQueue
+{
+public:
+    static constexpr uint32_t stateChange = 0;
+    static constexpr uint32_t loop = 1;
+    static constexpr uint32_t overflow = 2;
+
+    // Advances the state machine instance and records each state that changed.
+    bool advanceStateMachine(rive::StateMachineInstance* smi, uint32_t tag, float seconds)
+    {
+        bool keepGoing = smi->advance(seconds);
+        for (size_t i = 0; i < smi->stateChangedCount(); ++i)
+        {
+            push(stateChange, tag, intern(layerStateName(smi->stateChangedByIndex(i))));
+        }
+        return keepGoing;
+    }
+
+    // Advances the animation instance and records whether it looped.
+    bool advanceAnimation(rive::LinearAnimationInstance* lai, uint32_t tag, float seconds)
+    {
+        bool keepGoing = lai->advance(seconds);
+        if (lai->didLoop())
+        {
+            push(loop, tag, 0);
+        }
+        return keepGoing;
+    }
+
+    // Takes the oldest records not yet drained and returns a Uint32Array view of them. Records
+    // that wrap around the end of the ring come back from the next call, so call until the view
+    // is empty. The view is invalidated by the next advance or drain() and if the wasm heap grows.
+    emscripten::val drain()
+    {
+        if (m_Dropped > 0)
+        {
+            m_Overflow = {overflow, 0, 0, m_Dropped};
+            m_Dropped = 0;
+            return emscripten::val(
+                emscripten::typed_memory_view(m_Overflow.size(), m_Overflow.data()));
+        }
+        uint32_t start = m_Head % kMaxRecords;
+        uint32_t count = std::min(m_Tail - m_Head, kMaxRecords - start);
+        m_Head += count;
+        return emscripten::val(
+            emscripten::typed_memory_view(count * kRecordSize, &m_Records[start * kRecordSize]));
+    }
+
+    // Names are only ever added, so JS fetches each one once and caches it by id.
+    std::string name(uint32_t id) const { return id < m_Names.size() ? m_Names[id] : ""; }
+
+private:
+    static constexpr uint32_t kRecordSize = 4;
+    // A power of two, so the head and tail stay in step with the ring when they wrap around.
+    static constexpr uint32_t kMaxRecords = 4096;
+
+    void push(uint32_t type, uint32_t tag, uint32_t nameId)
+    {
+        if (m_Tail - m_Head == kMaxRecords)
+        {
+            ++m_Dropped;
+            return;
+        }
+        uint32_t* record = &m_Records[(m_Tail % kMaxRecords) * kRecordSize];
+        record[0] = type;
+        record[1] = tag;
+        record[2] = nameId;
+        record[3] = 0;
+        ++m_Tail;
+    }
+
+    uint32_t intern(const std::string& name)
+    {
+        auto result = m_NameIds.emplace(name, m_Names.size());
+        if (result.second)
+        {
+            m_Names.push_back(name);
+        }
+        return result.first->second;
+    }
+
+    std::array<uint32_t, kMaxRecords * kRecordSize> m_Records;
+    // Counts of records ever written and drained; their difference is how many are queued.
+    uint32_t m_Head = 0;
+    uint32_t m_Tail = 0;
+    uint32_t m_Dropped = 0;
+    std::array<uint32_t, kRecordSize> m_Overflow; // What drain() last reported dropping.
+    std::vector<std::string> m_Names;
+    std::unordered_map<std::string, uint32_t> m_NameIds;
+};
+
+// Resolves names on an artboard instance to integer handles, so code that drives the same named
+// objects every frame can pass a handle to nodeAt() and friends instead of a string that gets
+// matched against every object on the artboard on each call. Component handles are indices into
+// the artboard's objects; animation and state machine handles are the indices taken by
+// animationByIndex() and stateMachineByIndex(). Each type has its own name table, so a name
+// resolves to the same object the artboard's lookup by name for that type finds, even if an
+// object of another type shares the name. Unknown names resolve to -1.
+//
+// The name tables are built on first use. Holds on to the artboard instance, so it must be
+// deleted first.
+class ComponentIndex
+{
+public:
+    ComponentIndex(rive::ArtboardInstance* artboard) : m_Artboard(artboard) {}
+
+    int transformComponent(const std::string& name) { return lookup(m_TransformComponents, name); }
+    int node(const std::string& name) { return lookup(m_Nodes, name); }
+    int bone(const std::string& name) { return lookup(m_Bones, name); }
+    int rootBone(const std::string& name) { return lookup(m_RootBones, name); }
+    int animation(const std::string& name) { return lookup(m_Animations, name); }
+    int stateMachine(const std::string& name) { return lookup(m_StateMachines, name); }
+
+private:
+    using NameTable = std::unordered_map<std::string, int>;
+
+    int lookup(const NameTable& names, const std::string& name)
+    {
+        if (!m_Built)
+        {
+            build();
+        }
+        auto itr = names.find(name);
+        return itr == names.end() ? -1 : itr->second;
+    }
+
+    void build()
+    {
+        // emplace() leaves an existing entry alone, so the first object of each type with a name
+        // wins, as it does for the artboard's own lookups by name.
+        const auto& objects = m_Artboard->objects();
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            rive::Core* object = objects[i];
+            if (object == nullptr || !object->is<rive::TransformComponent>())
+            {
+                continue;
+            }
+            const std::string& name = object->as<rive::TransformComponent>()->name();
+            m_TransformComponents.emplace(name, static_cast<int>(i));
+            if (object->is<rive::Node>())
+            {
+                m_Nodes.emplace(name, static_cast<int>(i));
+            }
+            if (object->is<rive::Bone>())
+            {
+                m_Bones.emplace(name, static_cast<int>(i));
+            }
+            if (object->is<rive::RootBone>())
+            {
+                m_RootBones.emplace(name, static_cast<int>(i));
+            }
+        }
+        for (size_t i = 0; i < m_Artboard->animationCount(); ++i)
+        {
+            m_Animations.emplace(m_Artboard->animation(i)->name(), static_cast<int>(i));
+        }
+        for (size_t i = 0; i < m_Artboard->stateMachineCount(); ++i)
+        {
+            m_StateMachines.emplace(m_Artboard->stateMachine(i)->name(), static_cast<int>(i));
+        }
+        m_Built = true;
+    }
+
+    rive::ArtboardInstance* m_Artboard;
+    bool m_Built = false;
+    NameTable m_TransformComponents;
+    NameTable m_Nodes;
+    NameTable m_Bones;
+    NameTable m_RootBones;
+    NameTable m_Animations;
+    NameTable m_StateMachines;
+};
+
+// Returns the component at a ComponentIndex handle, or null if it isn't a T.
+template <typename T> static T* componentAt(rive::ArtboardInstance& artboard, size_t handle)
+{
+    const auto& objects = artboard.objects();
+    if (handle >= objects.size() || objects[handle] == nullptr || !objects[handle]->is<T>())
+    {
+        return nullptr;
+    }
+    return objects[handle]->as<T>();
+}
+
+// The local transforms and world transforms of a list of transform components, laid out as
+// arrays of floats in wasm memory so JS can read and write many of them through two views instead
+// of an embind call per property:
+//
+//   locals - 5 floats per component: x, y, rotation, scaleX, scaleY
+//   worlds - 6 floats per component: the world transform's xx, xy, yx, yy, tx, ty
+//
+// The constructor and read() fill both from the components; write() passes the locals back.
+// World transforms are only brought up to date when the artboard advances, so read after
+// advancing. Handles that aren't transform components read as zeros and are skipped when
+// writing, as are x and y for bones, whose position follows their parent bone.
+//
+// Holds on to the components, so it must be deleted before the artboard instance.
+class TransformBatch
+{
+public:
+    static constexpr size_t kLocalStride = 5;
+    static constexpr size_t kWorldStride = 6;
+
+    TransformBatch(rive::ArtboardInstance* artboard, emscripten::val handles)
+    {
+        for (int handle : emscripten::convertJSArrayToNumberVector<int>(handles))
+        {
+            m_Components.push_back(
+                handle < 0 ? nullptr : componentAt<rive::TransformComponent>(*artboard, handle));
+        }
+        m_Locals.resize(m_Components.size() * kLocalStride);
+        m_Worlds.resize(m_Components.size() * kWorldStride);
+        // Start from the components' current values, so a write() before any read() doesn't
+        // zero out transforms the caller never touched.
+        read();
+    }
+
+    // Returns Float32Array views of the locals and worlds. They're invalidated if the wasm heap
+    // grows, so fetch fresh ones after anything that may allocate.
+    emscripten::val locals()
+    {
+        return emscripten::val(emscripten::typed_memory_view(m_Locals.size(), m_Locals.data()));
+    }
+    emscripten::val worlds()
+    {
+        return emscripten::val(emscripten::typed_memory_view(m_Worlds.size(), m_Worlds.data()));
+    }
+
+    void read()
+    {
+        for (size_t i = 0; i < m_Components.size(); ++i)
+        {
+            rive::TransformComponent* component = m_Components[i];
+            if (component == nullptr)
+            {
+                continue;
+            }
+            float* local = &m_Locals[i * kLocalStride];
+            local[0] = component->x();
+            local[1] = component->y();
+            local[2] = component->rotation();
+            local[3] = component->scaleX();
+            local[4] = component->scaleY();
+            const rive::Mat2D& world = component->worldTransform();
+            float* out = &m_Worlds[i * kWorldStride];
+            for (size_t j = 0; j < kWorldStride; ++j)
+            {
+                out[j] = world[j];
+            }
+        }
+    }
+
+    // The components' setters ignore values that haven't changed, so writing back locals that
+    // JS didn't touch doesn't dirty anything.
+    void write()
+    {
+        for (size_t i = 0; i < m_Components.size(); ++i)
+        {
+            rive::TransformComponent* component = m_Components[i];
+            if (component == nullptr)
+            {
+                continue;
+            }
+            const float* local = &m_Locals[i * kLocalStride];
+            if (component->is<rive::Node>())
+            {
+                component->as<rive::Node>()->x(local[0]);
+                component->as<rive::Node>()->y(local[1]);
+            }
+            else if (component->is<rive::RootBone>())
+            {
+                component->as<rive::RootBone>()->x(local[0]);
+                component->as<rive::RootBone>()->y(local[1]);
+            }
+            component->rotation(local[2]);
+            component->scaleX(local[3]);
+            component->scaleY(local[4]);
+        }
+    }
+
+private:
+    std::vector<rive::TransformComponent*> m_Components;
+    std::vector<float> m_Locals;
+    std::vector<float> m_Worlds;
+};
+
+#ifdef ENABLE_QUERY_FLAT_VERTICES
+// Flattened path vertices packed into reusable wasm memory, so tooling can read whole paths
+// through a typed array view rather than a FlattenedPath object with an embind call per vertex
+// component. Each vertex is 7 floats:
+//
+//   type, x, y, inX, inY, outX, outY
+//
+// where type is 1 for cubic vertices and 0 for straight ones, whose in and out points are set to
+// the vertex itself. flattenAll() also lists each path as 3 uint32s in paths(): the path's index
+// in the artboard's objects (the same index flattenPath() takes), its first vertex and its vertex
+// count.
+//
+// Memory is kept between calls, so flattening the same artboard every frame stops allocating once
+// the buffer has grown to fit.
+class FlattenedPathBuffer
+{
+public:
+    static constexpr size_t kVertexStride = 7;
+    static constexpr size_t kPathStride = 3;
+
+    // Flattens the path at 'index' in the artboard's objects, replacing the buffer's contents.
+    // Returns its vertex count, or -1 if there's no path at that index.
+    int flatten(rive::ArtboardInstance& artboard, size_t index, bool transformToParent)
+    {
+        m_Vertices.clear();
+        m_Paths.clear();
+        auto path = componentAt<rive::Path>(artboard, index);
+        if (path == nullptr)
+        {
+            return -1;
+        }
+        return static_cast<int>(append(path, index, transformToParent));
+    }
+
+    // Flattens every path on the artboard, replacing the buffer's contents. Returns the number of
+    // paths.
+    size_t flattenAll(rive::ArtboardInstance& artboard, bool transformToParent)
+    {
+        m_Vertices.clear();
+        m_Paths.clear();
+        const auto& objects = artboard.objects();
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            if (objects[i] != nullptr && objects[i]->is<rive::Path>())
+            {
+                append(objects[i]->as<rive::Path>(), i, transformToParent);
+            }
+        }
+        return m_Paths.size() / kPathStride;
+    }
+
+    // Returns Float32Array and Uint32Array views of the vertices and paths. They're invalidated by
+    // the next flatten and if the wasm heap grows, so fetch fresh ones after each flatten.
+    emscripten::val vertices()
+    {
+        return emscripten::val(
+            emscripten::typed_memory_view(m_Vertices.size(), m_Vertices.data()));
+    }
+    emscripten::val paths()
+    {
+        return emscripten::val(emscripten::typed_memory_view(m_Paths.size(), m_Paths.data()));
+    }
+
+private:
+    size_t append(rive::Path* path, size_t index, bool transformToParent)
+    {
+        std::unique_ptr<rive::FlattenedPath> flat(path->makeFlat(transformToParent));
+        const auto& vertices = flat->vertices();
+        m_Paths.push_back(static_cast<uint32_t>(index));
+        m_Paths.push_back(static_cast<uint32_t>(m_Vertices.size() / kVertexStride));
+        m_Paths.push_back(static_cast<uint32_t>(vertices.size()));
+        for (rive::PathVertex* vertex : vertices)
+        {
+            bool isCubic = vertex->is<rive::CubicVertex>();
+            rive::Vec2D point(vertex->x(), vertex->y());
+            rive::Vec2D in = isCubic ? vertex->as<rive::CubicVertex>()->renderIn() : point;
+            rive::Vec2D out = isCubic ? vertex->as<rive::CubicVertex>()->renderOut() : point;
+            m_Vertices.insert(m_Vertices.end(),
+                              {isCubic ? 1.0f : 0.0f, point.x, point.y, in.x, in.y, out.x, out.y});
+        }
+        return vertices.size();
+    }
+
+    std::vector<float> m_Vertices;
+    std::vector<uint32_t> m_Paths;
+};
+#endif
+
 class DynamicRectanizer
 {
 public:
@@ -163,6 +919,7 @@ private:
 EMSCRIPTEN_BINDINGS(RiveWASM)
 {
     function("load", &load, allow_raw_pointers());
+    function("loadFromBuffer", &loadFromBuffer, allow_raw_pointers());
     function("computeAlignment", &computeAlignment);
     function("mapXY", &mapXY);
     function("hasListeners", &hasListeners, allow_raw_pointers());
@@ -197,6 +954,13 @@ EMSCRIPTEN_BINDINGS(RiveWASM)
         .function("outY", optional_override([](rive::FlattenedPath& self, size_t index) -> float {
                       return self.vertices()[index]->as<rive::CubicVertex>()->renderOut()[1];
                   }));
+
+    class_<FlattenedPathBuffer>("FlattenedPathBuffer")
+        .constructor<>()
+        .function("flatten", &FlattenedPathBuffer::flatten)
+        .function("flattenAll", &FlattenedPathBuffer::flattenAll)
+        .function("vertices", &FlattenedPathBuffer::vertices)
+        .function("paths", &FlattenedPathBuffer::paths);
 #endif
 
     class_<rive::Vec2D>("Vec2D")
@@ -306,6 +1070,13 @@ EMSCRIPTEN_BINDINGS(RiveWASM)
                       return self.find<rive::RootBone>(name);
                   }),
                   allow_raw_pointers())
+        // Components by ComponentIndex handle
+        .function("transformComponentAt",
+                  &componentAt<rive::TransformComponent>,
+                  allow_raw_pointers())
+        .function("nodeAt", &componentAt<rive::Node>, allow_raw_pointers())
+        .function("boneAt", &componentAt<rive::Bone>, allow_raw_pointers())
+        .function("rootBoneAt", &componentAt<rive::RootBone>, allow_raw_pointers())
         // Animations
         .function("animationByIndex",
                   optional_override(
@@ -419,6 +1190,26 @@ EMSCRIPTEN_BINDINGS(RiveWASM)
         .function("advance", &rive::StateMachineInstance::advance, allow_raw_pointers())
         .function("inputCount", &rive::StateMachineInstance::inputCount)
         .function("input", &rive::StateMachineInstance::input, allow_raw_pointers())
+        .function("inputIndex", &inputIndex)
+        .function("setInputs",
+                  optional_override([](rive::StateMachineInstance& self, emscripten::val pairs) {
+                      // Flat (index, value) pairs, converted in a single crossing. Pairs whose
+                      // index isn't an input's, like the -1 inputIndex() returns for unknown
+                      // names, are skipped.
+                      auto values = emscripten::convertJSArrayToNumberVector<double>(pairs);
+                      for (size_t i = 0; i + 1 < values.size(); i += 2)
+                      {
+                          double index = values[i];
+                          if (!(index >= 0 && index < self.inputCount()) ||
+                              index != std::floor(index))
+                          {
+                              continue;
+                          }
+                          setInputValue(&self,
+                                        static_cast<size_t>(index),
+                                        static_cast<float>(values[i + 1]));
+                      }
+                  }))
         .function("pointerDown",
                   optional_override([](rive::StateMachineInstance& self, double x, double y) {
                       self.pointerDown(rive::Vec2D((float)x, (float)y));
@@ -435,20 +1226,7 @@ EMSCRIPTEN_BINDINGS(RiveWASM)
         .function(
             "stateChangedNameByIndex",
             optional_override([](rive::StateMachineInstance& self, size_t index) -> std::string {
-                const rive::LayerState* state = self.stateChangedByIndex(index);
-                if (state != nullptr)
-                    switch (state->coreType())
-                    {
-                        case rive::AnimationState::typeKey:
-                            return state->as<rive::AnimationState>()->animation()->name();
-                        case rive::EntryState::typeKey:
-                            return "entry";
-                        case rive::ExitState::typeKey:
-                            return "exit";
-                        case rive::AnyState::typeKey:
-                            return "any";
-                    }
-                return "unknown";
+                return layerStateName(self.stateChangedByIndex(index));
             }),
             allow_raw_pointers());
 
@@ -523,6 +1301,51 @@ EMSCRIPTEN_BINDINGS(RiveWASM)
         .field("maxX", &rive::AABB::maxX)
         .field("maxY", &rive::AABB::maxY);
 
+    class_<ListenerBounds>("ListenerBounds")
+        .constructor<rive::StateMachineInstance*>()
+        .function("pointerMove", &ListenerBounds::pointerMove)
+        .function("pointerDown", &ListenerBounds::pointerDown)
+        .function("pointerUp", &ListenerBounds::pointerUp);
+
+    class_<StateMachineInputSlots>("StateMachineInputSlots")
+        .constructor<rive::StateMachineInstance*>()
+        .function("values", &StateMachineInputSlots::values)
+        .function("apply", &StateMachineInputSlots::apply);
+
+    class_<ComponentIndex>("ComponentIndex")
+        .constructor<rive::ArtboardInstance*>()
+        .function("transformComponent", &ComponentIndex::transformComponent)
+        .function("node", &ComponentIndex::node)
+        .function("bone", &ComponentIndex::bone)
+        .function("rootBone", &ComponentIndex::rootBone)
+        .function("animation", &ComponentIndex::animation)
+        .function("stateMachine", &ComponentIndex::stateMachine);
+
+    class_<TransformBatch>("TransformBatch")
+        .constructor<rive::ArtboardInstance*, emscripten::val>()
+        .function("locals", &TransformBatch::locals)
+        .function("worlds", &TransformBatch::worlds)
+        .function("read", &TransformBatch::read)
+        .function("write", &TransformBatch::write);
+
+    class_<EventQueue>("EventQueue")
+        .constructor<>()
+        .function("advanceStateMachine", &EventQueue::advanceStateMachine, allow_raw_pointers())
+        .function("advanceAnimation", &EventQueue::advanceAnimation, allow_raw_pointers())
+        .function("drain", &EventQueue::drain)
+        .function("name", &EventQueue::name)
+        .class_property("stateChange", &EventQueue::stateChange)
+        .class_property("loop", &EventQueue::loop)
+        .class_property("overflow", &EventQueue::overflow);
+
+    class_<FileBuffer>("FileBuffer")
+        .constructor<size_t>()
+        .function("bytes", &FileBuffer::bytes)
+        .function("size", &FileBuffer::size)
+        .function("reserve", &FileBuffer::reserve)
+        .function("append", &FileBuffer::append)
+        .function("release", &FileBuffer::release);
+
     class_<DynamicRectanizer>("DynamicRectanizer")
         .constructor<int>()
         .function("reset", &DynamicRectanizer::reset)
@@ -13,15 +13,22 @@
 #include <emscripten.h>
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
 #include <string>
 #include <vector>
 
 using namespace emscripten;
 
 // Computes the post-transform bounding box of an array of points in high performance WASM SIMD.
-static std::array<float, 4> bbox(const float m[6], const float* vertexData, int numVertexFloats)
+// Returns {left, top, right, bottom}, unrounded.
+static std::array<float, 4> bboxUnrounded(const float m[6],
+                                          const float* vertexData,
+                                          int numVertexFloats)
 {
     using float2 = skvx::Vec<2, float>;
     using float4 = skvx::Vec<4, float>;
@@ -62,107 +69,258 @@ static std::array<float, 4> bbox(const float m[6], const float* vertexData, int
     }
     assert(i == numVertexFloats);
 
-    // Merge the two parallel bounding boxes into one complete, translated, integer bounding box.
-    float2 topLeft = floor(min(partialTopLefts.lo, partialTopLefts.hi) + translate);
-    float2 botRight = ceil(max(partialBotRights.lo, partialBotRights.hi) + translate);
+    // Merge the two parallel bounding boxes into one complete, translated bounding box.
+    float2 topLeft = min(partialTopLefts.lo, partialTopLefts.hi) + translate;
+    float2 botRight = max(partialBotRights.lo, partialBotRights.hi) + translate;
     return {topLeft.x(), topLeft.y(), botRight.x(), botRight.y()};
 }
 
-class RendererWrapper : public wrapper<rive::Renderer>
+// Transforms an array of points by an affine matrix in WASM SIMD, two points at a time.
+static void transformPoints(const float m[6], const float* in, float* out, size_t numFloats)
 {
-public:
-    EMSCRIPTEN_WRAPPER(RendererWrapper);
-
-    void save() override { call<void>("save"); }
+    using float2 = skvx::Vec<2, float>;
+    using float4 = skvx::Vec<4, float>;
 
-    void restore() override { call<void>("restore"); }
+    assert(numFloats % 2 == 0); // numFloats must be even -- 2 floats per point.
 
-    void transform(const rive::Mat2D& transform) override
+    float4 scale = {m[0], m[3], m[0], m[3]};
+    float4 skew = {m[2], m[1], m[2], m[1]};
+    float4 translate = {m[4], m[5], m[4], m[5]};
+    size_t i = 0;
+    for (; i + 4 <= numFloats; i += 4)
     {
-        call<void>("transform",
-                   transform.xx(),
-                   transform.xy(),
-                   transform.yx(),
-                   transform.yy(),
-                   transform.tx(),
-                   transform.ty());
+        float4 v = float4::Load(in + i);
+        (v * scale + v.yxwz() * skew + translate).store(out + i);
     }
-
-    void align(rive::Fit fit, JsAlignment alignment, const rive::AABB& foo, const rive::AABB& bar)
+    if (i < numFloats)
     {
-        transform(computeAlignment(fit, convertAlignment(alignment), foo, bar));
+        // Odd number of points.
+        float2 v = float2::Load(in + i);
+        (v * scale.lo + v.yx() * skew.lo + translate.lo).store(out + i);
     }
+}
 
-    void drawPath(rive::RenderPath* path, rive::RenderPaint* paint) override
+// Same as bboxUnrounded(), rounded out to an integer bounding box.
+static std::array<float, 4> bbox(const float m[6], const float* vertexData, int numVertexFloats)
+{
+    auto [l, t, r, b] = bboxUnrounded(m, vertexData, numVertexFloats);
+    return {floorf(l), floorf(t), ceilf(r), ceilf(b)};
+}
+
+// Returns how much to scale a mesh when rasterizing it, so it isn't drawn at a higher resolution
+// than the part of its texture it samples. Compares the longest extents of the texels the UVs cover
+// and of the mesh on screen, which is unaffected by flips and 90 degree rotations and conservative
+// for others. Higher quality values keep more resolution; 1 matches the texture's texel density.
+static float meshLevelOfDetail(const std::array<float, 4>& screenBounds,
+                               const float* uvData,
+                               int numUVFloats,
+                               int textureWidth,
+                               int textureHeight,
+                               float quality)
+{
+    if (textureWidth <= 0 || textureHeight <= 0 || quality <= 0)
     {
-        call<void>("_drawPath", path, paint);
+        return 1;
     }
-
-    void clipPath(rive::RenderPath* path) override { call<void>("_clipPath", path); }
-
-    void drawImage(const rive::RenderImage* image, rive::BlendMode value, float opacity) override
+    static const float identity[6] = {1, 0, 0, 1, 0, 0};
+    auto [u0, v0, u1, v1] = bboxUnrounded(identity, uvData, numUVFloats);
+    float texelExtent = std::max((u1 - u0) * textureWidth, (v1 - v0) * textureHeight);
+    float screenExtent =
+        std::max(screenBounds[2] - screenBounds[0], screenBounds[3] - screenBounds[1]);
+    if (!(screenExtent > 0))
     {
-        call<void>("_drawImage", image, value, opacity);
+        return 1;
     }
+    return std::min(quality * texelExtent / screenExtent, 1.f);
+}
 
-    void drawImageMesh(const rive::RenderImage* image,
-                       rive::rcp<rive::RenderBuffer> vertices_f32,
-                       rive::rcp<rive::RenderBuffer> uvCoords_f32,
-                       rive::rcp<rive::RenderBuffer> indices_u16,
-                       rive::BlendMode value,
-                       float opacity) override
+// 32-bit FNV-1a.
+static constexpr uint32_t kHashSeed = 2166136261u;
+static uint32_t hashBytes(uint32_t hash, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
     {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
 
-        auto vtx = rive::DataRenderBuffer::Cast(vertices_f32.get());
-        auto uv = rive::DataRenderBuffer::Cast(uvCoords_f32.get());
-        auto indices = rive::DataRenderBuffer::Cast(indices_u16.get());
-
-        assert(uv->count() == vtx->count());
-        if (!vtx->count() || !indices->count())
-        {
-            return;
-        }
-
-        emscripten::val uvJS{emscripten::typed_memory_view(uv->count(), uv->f32s())};
-        emscripten::val vtxJS{emscripten::typed_memory_view(vtx->count(), vtx->f32s())};
-        emscripten::val indicesJS{emscripten::typed_memory_view(indices->count(), indices->u16s())};
-
-        // Compute the mesh's bounding box.
-        float m[6];
-        emscripten::val mJS{emscripten::typed_memory_view(6, m)};
-        call<void>("_getMatrix", mJS);
-        auto [l, t, r, b] = bbox(m, vtx->f32s(), vtx->count());
-
-        call<void>("_drawImageMesh", image, value, opacity, vtxJS, uvJS, indicesJS, l, t, r, b);
+// 64-bit FNV-1a.
+static constexpr uint64_t kHashSeed64 = 14695981039346656037ull;
+static uint64_t hashBytes64(uint64_t hash, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
     }
+    return hash;
+}
+
+// Path verbs as recorded by RenderPathWrapper. These must match the PATH_VERB_* constants in
+// renderer.js.
+enum class C2DPathVerb : uint8_t
+{
+    move = 0,
+    line = 1,
+    cubic = 2,
+    close = 3,
 };
 
+static uint64_t gNextPathGeometryId = 0;
+
+// Records path geometry in WASM memory and hands it to JS in a single call, as typed array views
+// over the verbs and points, the next time the path is drawn. This way building a path costs one
+// up-call to JS rather than one per verb.
 class RenderPathWrapper : public wrapper<rive::RenderPath>
 {
 public:
     EMSCRIPTEN_WRAPPER(RenderPathWrapper);
 
-    void rewind() override { call<void>("rewind"); }
+    void rewind() override
+    {
+        m_Verbs.clear();
+        m_Points.clear();
+        invalidate();
+    }
 
     void addRenderPath(rive::RenderPath* path, const rive::Mat2D& transform) override
     {
+        auto src = static_cast<RenderPathWrapper*>(path);
         float xx = transform.xx();
         float xy = transform.xy();
         float yx = transform.yx();
         float yy = transform.yy();
         float tx = transform.tx();
         float ty = transform.ty();
-        call<void>("addPath", path, xx, xy, yx, yy, tx, ty);
+        // Size first and read src through indices; src may be this path.
+        size_t numVerbs = m_Verbs.size();
+        size_t numSrcVerbs = src->m_Verbs.size();
+        m_Verbs.resize(numVerbs + numSrcVerbs);
+        std::copy_n(src->m_Verbs.data(), numSrcVerbs, m_Verbs.data() + numVerbs);
+        size_t numSrcPoints = src->m_Points.size();
+        m_Points.reserve(m_Points.size() + numSrcPoints);
+        for (size_t i = 0; i < numSrcPoints; i += 2)
+        {
+            float x = src->m_Points[i];
+            float y = src->m_Points[i + 1];
+            m_Points.push_back(xx * x + yx * y + tx);
+            m_Points.push_back(xy * x + yy * y + ty);
+        }
+        invalidate();
     }
-    void fillRule(rive::FillRule value) override { call<void>("fillRule", value); }
+    // The fill rule is recorded with each draw, since it can change before the draw is flushed.
+    void fillRule(rive::FillRule value) override { m_FillRule = value; }
+    rive::FillRule currentFillRule() const { return m_FillRule; }
 
-    void moveTo(float x, float y) override { call<void>("moveTo", x, y); }
-    void lineTo(float x, float y) override { call<void>("lineTo", x, y); }
+    void moveTo(float x, float y) override
+    {
+        m_Verbs.push_back(C2DPathVerb::move);
+        m_Points.insert(m_Points.end(), {x, y});
+        invalidate();
+    }
+    void lineTo(float x, float y) override
+    {
+        m_Verbs.push_back(C2DPathVerb::line);
+        m_Points.insert(m_Points.end(), {x, y});
+        invalidate();
+    }
     void cubicTo(float ox, float oy, float ix, float iy, float x, float y) override
     {
-        call<void>("cubicTo", ox, oy, ix, iy, x, y);
+        m_Verbs.push_back(C2DPathVerb::cubic);
+        m_Points.insert(m_Points.end(), {ox, oy, ix, iy, x, y});
+        invalidate();
+    }
+    void close() override
+    {
+        m_Verbs.push_back(C2DPathVerb::close);
+        invalidate();
+    }
+
+    // Returns the bounds of the path's points (which contain its curves), or false if it's empty.
+    bool localBounds(std::array<float, 4>* bounds)
+    {
+        if (m_Points.empty())
+        {
+            return false;
+        }
+        if (m_BoundsDirty)
+        {
+            static const float identity[6] = {1, 0, 0, 1, 0, 0};
+            m_Bounds = bboxUnrounded(identity, m_Points.data(), m_Points.size());
+            m_BoundsDirty = false;
+        }
+        *bounds = m_Bounds;
+        return true;
     }
-    void close() override { call<void>("close"); }
+
+    // Rebuilds the JS Path2D if the geometry changed since it was last drawn, returning whether
+    // it did. The views are only valid for the duration of the call.
+    bool syncToJS()
+    {
+        if (m_Version == m_SyncedVersion)
+        {
+            return false;
+        }
+        m_SyncedVersion = m_Version;
+        // Paths are commonly rewound and rebuilt with the same geometry every frame. Keep the
+        // existing Path2D in that case.
+        uint64_t hash = hashBytes64(kHashSeed64, m_Verbs.data(), m_Verbs.size());
+        hash = hashBytes64(hash, m_Points.data(), m_Points.size() * sizeof(float));
+        if (m_GeometryId != 0 && hash == m_SyncedHash)
+        {
+            return false;
+        }
+        static_assert(sizeof(C2DPathVerb) == sizeof(uint8_t));
+        emscripten::val verbsJS{
+            emscripten::typed_memory_view(m_Verbs.size(),
+                                          reinterpret_cast<const uint8_t*>(m_Verbs.data()))};
+        emscripten::val pointsJS{emscripten::typed_memory_view(m_Points.size(), m_Points.data())};
+        call<void>("_updatePath", verbsJS, pointsJS);
+        m_SyncedHash = hash;
+        m_GeometryId = ++gNextPathGeometryId;
+        return true;
+    }
+
+    // Id of the JS object in renderer.js's registry of render objects.
+    uint32_t handle() const
+    {
+        if (!m_Handle)
+        {
+            m_Handle = call<uint32_t>("_getHandle");
+        }
+        return m_Handle;
+    }
+
+    // Identifies the geometry as of the last syncToJS(). It only changes when the geometry's
+    // 64-bit hash does, and is never shared with other geometry, even another path's.
+    uint64_t geometryId() const
+    {
+        assert(m_Version == m_SyncedVersion);
+        return m_GeometryId;
+    }
+
+private:
+    void invalidate()
+    {
+        ++m_Version;
+        m_BoundsDirty = true;
+    }
+
+    std::vector<C2DPathVerb> m_Verbs;
+    std::vector<float> m_Points;
+    rive::FillRule m_FillRule = rive::FillRule::nonZero;
+    bool m_BoundsDirty = true;
+    std::array<float, 4> m_Bounds;
+    // Bumped by every edit, so unedited paths skip hashing their geometry when drawn.
+    uint32_t m_Version = 1;
+    uint32_t m_SyncedVersion = 0;
+    // Hash of the geometry the JS Path2D was last built from, and its id (0 before the first
+    // build).
+    uint64_t m_SyncedHash = 0;
+    uint64_t m_GeometryId = 0;
+    mutable uint32_t m_Handle = 0;
 };
 
 class RenderPaintWrapper;
@@ -172,14 +330,23 @@ private:
     std::vector<float> m_Stops;
     std::vector<rive::ColorInt> m_Colors;
 
+protected:
+    // Sends the gradient to JS in a single call, along with a hash of everything that defines it
+    // so JS can reuse a CanvasGradient it has already built for the same parameters. Returns the
+    // hash.
+    uint32_t passToJS(const RenderPaintWrapper& wrapper,
+                      const char* jsMethod,
+                      float sx,
+                      float sy,
+                      float ex,
+                      float ey) const;
+
 public:
     GradientShader(const rive::ColorInt colors[], const float stops[], int count) :
         m_Stops(stops, stops + count), m_Colors(colors, colors + count)
     {}
 
-    void passStopsToJS(const RenderPaintWrapper& wrapper);
-
-    virtual void passToJS(const RenderPaintWrapper& wrapper) = 0;
+    virtual uint32_t passToJS(const RenderPaintWrapper& wrapper) = 0;
 };
 
 class LinearGradientShader : public GradientShader
@@ -201,7 +368,7 @@ public:
         GradientShader(colors, stops, count), m_StartX(sx), m_StartY(sy), m_EndX(ex), m_EndY(ey)
     {}
 
-    void passToJS(const RenderPaintWrapper& wrapper) override;
+    uint32_t passToJS(const RenderPaintWrapper& wrapper) override;
 };
 
 class RadialGradientShader : public GradientShader
@@ -221,7 +388,7 @@ public:
         GradientShader(colors, stops, count), m_CenterX(cx), m_CenterY(cy), m_Radius(r)
     {}
 
-    void passToJS(const RenderPaintWrapper& wrapper) override;
+    uint32_t passToJS(const RenderPaintWrapper& wrapper) override;
 };
 
 class RenderPaintWrapper : public wrapper<rive::RenderPaint>
@@ -229,42 +396,128 @@ class RenderPaintWrapper : public wrapper<rive::RenderPaint>
 public:
     EMSCRIPTEN_WRAPPER(RenderPaintWrapper);
 
-    void color(unsigned int value) override { call<void>("color", value); }
-    void thickness(float value) override { call<void>("thickness", value); }
-    void join(rive::StrokeJoin value) override { call<void>("join", value); }
-    void cap(rive::StrokeCap value) override { call<void>("cap", value); }
-    void blendMode(rive::BlendMode value) override { call<void>("blendMode", value); }
+    void color(unsigned int value) override
+    {
+        m_Color = value;
+        m_ShaderHash = 0;
+        call<void>("color", value);
+    }
+    void thickness(float value) override
+    {
+        m_Thickness = value;
+        call<void>("thickness", value);
+    }
+    void join(rive::StrokeJoin value) override
+    {
+        m_Join = value;
+        call<void>("join", value);
+    }
+    void cap(rive::StrokeCap value) override
+    {
+        m_Cap = value;
+        call<void>("cap", value);
+    }
+    void blendMode(rive::BlendMode value) override
+    {
+        m_BlendMode = value;
+        call<void>("blendMode", value);
+    }
 
-    void style(rive::RenderPaintStyle value) override { call<void>("style", value); }
+    void style(rive::RenderPaintStyle value) override
+    {
+        m_Style = value;
+        call<void>("style", value);
+    }
 
     void shader(rive::rcp<rive::RenderShader> shader) override
     {
-        static_cast<GradientShader*>(shader.get())->passToJS(*this);
+        m_ShaderHash = static_cast<GradientShader*>(shader.get())->passToJS(*this);
     }
     void invalidateStroke() override {}
-};
 
-void GradientShader::passStopsToJS(const RenderPaintWrapper& wrapper)
-{
-    // Consider passing in a bulk op encoding into a single array.
-    for (std::size_t i = 0; i < m_Stops.size(); i++)
+    // Id of the JS object in renderer.js's registry of render objects.
+    uint32_t handle() const
     {
-        wrapper.call<void>("addStop", m_Colors[i], m_Stops[i]);
+        if (!m_Handle)
+        {
+            m_Handle = call<uint32_t>("_getHandle");
+        }
+        return m_Handle;
     }
+
+    // How far strokes drawn with this paint can reach outside of their path's points.
+    float strokeOutset() const
+    {
+        if (m_Style != rive::RenderPaintStyle::stroke)
+        {
+            return 0;
+        }
+        // Miter joins reach up to the canvas's default miterLimit (10) half-widths out. Round and
+        // bevel joins and square caps reach at most sqrt(2) half-widths out; round that up.
+        float halfWidth = m_Thickness * 0.5f;
+        return m_Join == rive::StrokeJoin::miter ? halfWidth * 10 : halfWidth * 1.5f;
+    }
+
+    // Hash of everything that affects how this paint draws.
+    uint32_t contentHash() const
+    {
+        uint32_t values[6] = {m_Color,
+                              static_cast<uint32_t>(m_Style),
+                              static_cast<uint32_t>(m_Join),
+                              static_cast<uint32_t>(m_Cap),
+                              static_cast<uint32_t>(m_BlendMode),
+                              m_ShaderHash};
+        uint32_t hash = hashBytes(kHashSeed, values, sizeof(values));
+        return hashBytes(hash, &m_Thickness, sizeof(m_Thickness));
+    }
+
+private:
+    rive::RenderPaintStyle m_Style = rive::RenderPaintStyle::fill;
+    float m_Thickness = 1;
+    rive::StrokeJoin m_Join = rive::StrokeJoin::miter;
+    rive::StrokeCap m_Cap = rive::StrokeCap::butt;
+    rive::BlendMode m_BlendMode = rive::BlendMode::srcOver;
+    uint32_t m_Color = 0;
+    uint32_t m_ShaderHash = 0; // Hash of the current gradient, or 0 for a solid color.
+    mutable uint32_t m_Handle = 0;
+};
+
+uint32_t GradientShader::passToJS(const RenderPaintWrapper& wrapper,
+                                  const char* jsMethod,
+                                  float sx,
+                                  float sy,
+                                  float ex,
+                                  float ey) const
+{
+    float points[4] = {sx, sy, ex, ey};
+    uint32_t hash = hashBytes(kHashSeed, jsMethod, strlen(jsMethod));
+    hash = hashBytes(hash, points, sizeof(points));
+    hash = hashBytes(hash, m_Colors.data(), m_Colors.size() * sizeof(rive::ColorInt));
+    hash = hashBytes(hash, m_Stops.data(), m_Stops.size() * sizeof(float));
+
+    emscripten::val colorsJS{emscripten::typed_memory_view(m_Colors.size(), m_Colors.data())};
+    emscripten::val stopsJS{emscripten::typed_memory_view(m_Stops.size(), m_Stops.data())};
+    wrapper.call<void>(jsMethod, hash, sx, sy, ex, ey, colorsJS, stopsJS);
+    return hash;
 }
 
-void LinearGradientShader::passToJS(const RenderPaintWrapper& wrapper)
+uint32_t LinearGradientShader::passToJS(const RenderPaintWrapper& wrapper)
 {
-    wrapper.call<void>("linearGradient", m_StartX, m_StartY, m_EndX, m_EndY);
-    passStopsToJS(wrapper);
+    return GradientShader::passToJS(wrapper, "linearGradient", m_StartX, m_StartY, m_EndX, m_EndY);
 }
 
-void RadialGradientShader::passToJS(const RenderPaintWrapper& wrapper)
+uint32_t RadialGradientShader::passToJS(const RenderPaintWrapper& wrapper)
 {
-    wrapper.call<void>("radialGradient", m_CenterX, m_CenterY, m_CenterX + m_Radius, m_CenterY);
-    passStopsToJS(wrapper);
+    return GradientShader::passToJS(wrapper,
+                                    "radialGradient",
+                                    m_CenterX,
+                                    m_CenterY,
+                                    m_CenterX + m_Radius,
+                                    m_CenterY);
 }
 
+static uint32_t gNextImageUniqueId = 0;
+
 class RenderImageWrapper : public wrapper<rive::RenderImage>
 {
 public:
@@ -282,6 +535,645 @@ public:
         m_Width = width;
         m_Height = height;
     }
+
+    // Id of the JS object in renderer.js's registry of render objects.
+    uint32_t handle() const
+    {
+        if (!m_Handle)
+        {
+            m_Handle = call<uint32_t>("_getHandle");
+        }
+        return m_Handle;
+    }
+
+    // Unlike handle(), which JS recycles once the image is deleted, this is never shared with
+    // another image, so it can identify the image in keys that outlive it.
+    uint32_t uniqueId() const { return m_UniqueId; }
+
+private:
+    mutable uint32_t m_Handle = 0;
+    const uint32_t m_UniqueId = ++gNextImageUniqueId;
+};
+
+// Mesh data staged for the WebGL atlas while draws are recorded. It's shared by every renderer,
+// since they all share the atlas. Indices are rebased to be relative to the first vertex of their
+// segment of the buffer, where segments are kept small enough for 16-bit indices.
+//
+// When JS flushes, it adds the meshes that need drawing to the atlas streams in draw order. Their
+// vertices are pretransformed into atlas pixel space, so consecutive meshes can be drawn together,
+// and JS uploads each stream with a single bufferSubData.
+class MeshStaging
+{
+public:
+    struct Location
+    {
+        uint32_t firstVertex;
+        uint32_t baseVertex;  // First vertex of the segment the mesh is in.
+        uint32_t indexOffset; // First index of the mesh.
+    };
+
+    Location append(const rive::DataRenderBuffer* vertices,
+                    const rive::DataRenderBuffer* uvs,
+                    const rive::DataRenderBuffer* indices)
+    {
+        size_t vertexCount = vertices->count() / 2;
+        size_t firstVertex = m_Vertices.size() / 2;
+        if (firstVertex + vertexCount - m_SegmentBaseVertex > kMaxSegmentVertices &&
+            firstVertex > m_SegmentBaseVertex)
+        {
+            m_SegmentBaseVertex = firstVertex;
+        }
+        Location location = {static_cast<uint32_t>(firstVertex),
+                             static_cast<uint32_t>(m_SegmentBaseVertex),
+                             static_cast<uint32_t>(m_Indices.size())};
+
+        m_Vertices.insert(m_Vertices.end(),
+                          vertices->f32s(),
+                          vertices->f32s() + vertices->count());
+        m_UVs.insert(m_UVs.end(), uvs->f32s(), uvs->f32s() + uvs->count());
+        size_t rebase = firstVertex - m_SegmentBaseVertex;
+        const uint16_t* meshIndices = indices->u16s();
+        for (size_t i = 0; i < indices->count(); ++i)
+        {
+            // The index has to land on one of this mesh's vertices, within the 16-bit segment.
+            size_t index = meshIndices[i] + rebase;
+            assert(meshIndices[i] < vertexCount && index <= UINT16_MAX);
+            m_Indices.push_back(static_cast<uint16_t>(index));
+        }
+        return location;
+    }
+
+    void reset()
+    {
+        m_Vertices.clear();
+        m_UVs.clear();
+        m_Indices.clear();
+        m_SegmentBaseVertex = 0;
+    }
+
+    void beginAtlas()
+    {
+        m_AtlasVertices.clear();
+        m_AtlasUVs.clear();
+        m_AtlasIndices.clear();
+        m_AtlasSegmentBaseVertex = 0;
+    }
+
+    // Appends a staged mesh to the atlas streams, transformed by m into atlas pixel space. Returns
+    // the first vertex of the atlas segment its indices are relative to.
+    uint32_t addToAtlas(const Location& location,
+                        uint32_t vertexCount,
+                        uint32_t indexCount,
+                        const float m[6])
+    {
+        size_t firstVertex = m_AtlasVertices.size() / 2;
+        if (firstVertex + vertexCount - m_AtlasSegmentBaseVertex > kMaxSegmentVertices &&
+            firstVertex > m_AtlasSegmentBaseVertex)
+        {
+            m_AtlasSegmentBaseVertex = firstVertex;
+        }
+
+        const float* vertices = m_Vertices.data() + location.firstVertex * 2;
+        m_AtlasVertices.resize(m_AtlasVertices.size() + vertexCount * 2);
+        transformPoints(m, vertices, m_AtlasVertices.data() + firstVertex * 2, vertexCount * 2);
+        const float* uvs = m_UVs.data() + location.firstVertex * 2;
+        m_AtlasUVs.insert(m_AtlasUVs.end(), uvs, uvs + vertexCount * 2);
+
+        // Move the indices from their staging segment to their atlas segment.
+        int rebase = static_cast<int>(firstVertex - m_AtlasSegmentBaseVertex) -
+                     static_cast<int>(location.firstVertex - location.baseVertex);
+        const uint16_t* indices = m_Indices.data() + location.indexOffset;
+        for (uint32_t i = 0; i < indexCount; ++i)
+        {
+            m_AtlasIndices.push_back(static_cast<uint16_t>(indices[i] + rebase));
+        }
+        return static_cast<uint32_t>(m_AtlasSegmentBaseVertex);
+    }
+
+    // Views of the atlas streams, which are only valid until the next WASM allocation.
+    emscripten::val atlasVertices() const
+    {
+        return emscripten::val(
+            emscripten::typed_memory_view(m_AtlasVertices.size(), m_AtlasVertices.data()));
+    }
+    emscripten::val atlasUVs() const
+    {
+        return emscripten::val(emscripten::typed_memory_view(m_AtlasUVs.size(), m_AtlasUVs.data()));
+    }
+    emscripten::val atlasIndices() const
+    {
+        return emscripten::val(
+            emscripten::typed_memory_view(m_AtlasIndices.size(), m_AtlasIndices.data()));
+    }
+
+private:
+    static constexpr size_t kMaxSegmentVertices = 1 << 16;
+
+    std::vector<float> m_Vertices;
+    std::vector<float> m_UVs;
+    std::vector<uint16_t> m_Indices;
+    size_t m_SegmentBaseVertex = 0;
+
+    std::vector<float> m_AtlasVertices;
+    std::vector<float> m_AtlasUVs;
+    std::vector<uint16_t> m_AtlasIndices;
+    size_t m_AtlasSegmentBaseVertex = 0;
+};
+
+static MeshStaging gMeshStaging;
+
+// Records draws into a linear buffer of 32-bit words in WASM memory: an opcode followed by its
+// operands, which are floats, enum values, or the handles of JS render objects. The JS renderer
+// replays the whole buffer in one loop when it flushes, so recording a draw doesn't cross into JS.
+class RendererWrapper : public wrapper<rive::Renderer>
+{
+public:
+    EMSCRIPTEN_WRAPPER(RendererWrapper);
+
+    // These must match the CMD_* constants in renderer.js.
+    enum class Command : uint32_t
+    {
+        save = 0,         // (no operands)
+        restore = 1,      // (no operands)
+        setTransform = 2, // xx, xy, yx, yy, tx, ty
+        drawPath = 3,     // path, paint, fillRule
+        clipPath = 4,     // path, fillRule
+        drawImage = 5,    // image, blendMode, opacity
+        clear = 6,        // damage l, t, r, b; index of the command after the frame's last one
+        drawDeferred = 7  // index into the JS renderer's list of deferred draws
+    };
+
+    void save() override
+    {
+        m_SaveStack.push_back(m_State);
+        push(Command::save);
+    }
+
+    void restore() override
+    {
+        assert(!m_SaveStack.empty()); // restore() called without matching save().
+        if (m_SaveStack.empty())
+        {
+            return;
+        }
+        m_State = m_SaveStack.back();
+        m_SaveStack.pop_back();
+        push(Command::restore);
+    }
+
+    // Transforms only compose the current matrix here. The result is sent to JS right before the
+    // next command that depends on it, so a run of nested transforms costs one setTransform, and
+    // transforms with nothing drawn under them cost nothing.
+    void transform(const rive::Mat2D& transform) override
+    {
+        m_State.transform = m_State.transform * transform;
+    }
+
+    void align(rive::Fit fit, JsAlignment alignment, const rive::AABB& foo, const rive::AABB& bar)
+    {
+        transform(computeAlignment(fit, convertAlignment(alignment), foo, bar));
+    }
+
+    void drawPath(rive::RenderPath* path, rive::RenderPaint* paint) override
+    {
+        auto pathWrapper = static_cast<RenderPathWrapper*>(path);
+        auto paintWrapper = static_cast<RenderPaintWrapper*>(paint);
+        ++m_DrawCount;
+        std::array<float, 4> bounds;
+        if (!pathWrapper->localBounds(&bounds))
+        {
+            ++m_CulledDrawCount;
+            return;
+        }
+        bounds = deviceBounds(bounds, paintWrapper->strokeOutset());
+        if (isCulled(bounds))
+        {
+            ++m_CulledDrawCount;
+            return;
+        }
+        if (pathWrapper->syncToJS())
+        {
+            ++m_PathSyncCount;
+        }
+        struct
+        {
+            uint64_t geometryId;
+            uint32_t fillRule;
+            uint32_t paintHash;
+        } drawInfo = {pathWrapper->geometryId(),
+                      static_cast<uint32_t>(pathWrapper->currentFillRule()),
+                      paintWrapper->contentHash()};
+        recordDraw(drawKey(Command::drawPath, &drawInfo, sizeof(drawInfo)), bounds);
+        syncTransform();
+        push(Command::drawPath);
+        push(pathWrapper->handle());
+        push(paintWrapper->handle());
+        push(static_cast<uint32_t>(pathWrapper->currentFillRule()));
+    }
+
+    void clipPath(rive::RenderPath* path) override
+    {
+        auto pathWrapper = static_cast<RenderPathWrapper*>(path);
+        // Subsequent draws outside the clip's bounds are culled.
+        std::array<float, 4> bounds;
+        auto& clip = m_State.clipBounds;
+        if (pathWrapper->localBounds(&bounds))
+        {
+            auto [l, t, r, b] = deviceBounds(bounds, 0);
+            clip = {std::max(clip[0], l),
+                    std::max(clip[1], t),
+                    std::min(clip[2], r),
+                    std::min(clip[3], b)};
+        }
+        else
+        {
+            // Clipping to an empty path hides everything.
+            clip = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+        }
+        if (pathWrapper->syncToJS())
+        {
+            ++m_PathSyncCount;
+        }
+        // Draws under the clip are only unchanged if the clip is too.
+        struct
+        {
+            uint64_t geometryId;
+            uint32_t fillRule;
+            uint32_t padding;
+        } clipInfo = {pathWrapper->geometryId(),
+                      static_cast<uint32_t>(pathWrapper->currentFillRule()),
+                      0};
+        m_State.clipHash = drawKey(Command::clipPath, &clipInfo, sizeof(clipInfo));
+        syncTransform();
+        push(Command::clipPath);
+        push(pathWrapper->handle());
+        push(static_cast<uint32_t>(pathWrapper->currentFillRule()));
+    }
+
+    void drawImage(const rive::RenderImage* image, rive::BlendMode value, float opacity) override
+    {
+        ++m_DrawCount;
+        // Images that haven't decoded yet don't know their size.
+        std::array<float, 4> bounds = {-INFINITY, -INFINITY, INFINITY, INFINITY};
+        if (image->width() > 0 && image->height() > 0)
+        {
+            bounds = deviceBounds({0, 0, (float)image->width(), (float)image->height()}, 0);
+            if (isCulled(bounds))
+            {
+                ++m_CulledDrawCount;
+                return;
+            }
+        }
+        auto imageWrapper = static_cast<const RenderImageWrapper*>(image);
+        uint32_t handle = imageWrapper->handle();
+        // Handles are recycled, so a new image could take this one's and look unchanged.
+        struct
+        {
+            uint32_t imageId;
+            int32_t width;
+            int32_t height;
+            uint32_t blendMode;
+            float opacity;
+        } drawInfo = {imageWrapper->uniqueId(),
+                      image->width(),
+                      image->height(),
+                      static_cast<uint32_t>(value),
+                      opacity};
+        recordDraw(drawKey(Command::drawImage, &drawInfo, sizeof(drawInfo)), bounds);
+        syncTransform();
+        push(Command::drawImage);
+        push(handle);
+        push(static_cast<uint32_t>(value));
+        push(opacity);
+    }
+
+    void drawImageMesh(const rive::RenderImage* image,
+                       rive::rcp<rive::RenderBuffer> vertices_f32,
+                       rive::rcp<rive::RenderBuffer> uvCoords_f32,
+                       rive::rcp<rive::RenderBuffer> indices_u16,
+                       rive::BlendMode value,
+                       float opacity) override
+    {
+
+        auto vtx = rive::DataRenderBuffer::Cast(vertices_f32.get());
+        auto uv = rive::DataRenderBuffer::Cast(uvCoords_f32.get());
+        auto indices = rive::DataRenderBuffer::Cast(indices_u16.get());
+
+        assert(uv->count() == vtx->count());
+        if (!vtx->count() || !indices->count())
+        {
+            return;
+        }
+
+        // Compute the mesh's bounding box.
+        const float* m = m_State.transform.values();
+        emscripten::val mJS{emscripten::typed_memory_view(6, m)};
+        auto screenBounds = bboxUnrounded(m, vtx->f32s(), vtx->count());
+        float l = floorf(screenBounds[0]);
+        float t = floorf(screenBounds[1]);
+        float r = ceilf(screenBounds[2]);
+        float b = ceilf(screenBounds[3]);
+        ++m_DrawCount;
+        if (isCulled({l, t, r, b}))
+        {
+            ++m_CulledDrawCount;
+            return;
+        }
+        float lodScale = meshLevelOfDetail(screenBounds,
+                                           uv->f32s(),
+                                           uv->count(),
+                                           image->width(),
+                                           image->height(),
+                                           m_MeshQuality);
+
+        // Identifies how the mesh gets rasterized into the atlas, so JS can reuse the result across
+        // frames while it doesn't change. The image size is included since it's only known once
+        // the image (and its texture) have loaded. Truncated to 53 bits to fit a JS number.
+        auto imageWrapper = static_cast<const RenderImageWrapper*>(image);
+        uint32_t imageInfo[3] = {imageWrapper->uniqueId(),
+                                 static_cast<uint32_t>(image->width()),
+                                 static_cast<uint32_t>(image->height())};
+        uint64_t key = hashBytes64(kHashSeed64, imageInfo, sizeof(imageInfo));
+        key = hashBytes64(key, m, 6 * sizeof(float));
+        key = hashBytes64(key, m_CanvasBounds.data(), sizeof(m_CanvasBounds));
+        key = hashBytes64(key, &lodScale, sizeof(lodScale));
+        key = hashBytes64(key, vtx->f32s(), vtx->count() * sizeof(float));
+        key = hashBytes64(key, uv->f32s(), uv->count() * sizeof(float));
+        key = hashBytes64(key, indices->u16s(), indices->count() * sizeof(uint16_t));
+
+        // Stage the mesh's data whether or not it's already in the atlas, in case the atlas gets
+        // repacked and everything in use has to be drawn again.
+        auto location = gMeshStaging.append(vtx, uv, indices);
+
+        // Meshes are drawn into an atlas by JS, which hands back the deferred draw that copies
+        // the mesh from the atlas to the canvas (or -1 if the mesh isn't visible).
+        int deferredIndex = call<int>("_drawImageMesh",
+                                      image,
+                                      value,
+                                      opacity,
+                                      mJS,
+                                      l,
+                                      t,
+                                      r,
+                                      b,
+                                      lodScale,
+                                      static_cast<double>(key >> 11),
+                                      location.firstVertex,
+                                      static_cast<uint32_t>(vtx->count() / 2),
+                                      location.baseVertex,
+                                      location.indexOffset,
+                                      static_cast<uint32_t>(indices->count()));
+        if (deferredIndex >= 0)
+        {
+            struct
+            {
+                uint64_t meshKey;
+                uint32_t blendMode;
+                float opacity;
+            } drawInfo = {key, static_cast<uint32_t>(value), opacity};
+            recordDraw(drawKey(Command::drawDeferred, &drawInfo, sizeof(drawInfo)), {l, t, r, b});
+            push(Command::drawDeferred);
+            push(static_cast<uint32_t>(deferredIndex));
+        }
+    }
+
+    // Clears the canvas, which starts a new frame. The canvas size is used for culling.
+    //
+    // Only the parts of the canvas that changed since the previous frame are cleared and redrawn.
+    // finishFrame() works those out once all of the frame's draws are known, and fills them in
+    // here; until then the whole canvas is cleared.
+    void clear(float canvasWidth, float canvasHeight)
+    {
+        finishFrame();
+        std::array<float, 4> canvasBounds = {0, 0, canvasWidth, canvasHeight};
+        if (canvasBounds != m_CanvasBounds)
+        {
+            m_FullRedraw = true;
+            m_CanvasBounds = canvasBounds;
+        }
+        m_PrevDraws.swap(m_Draws);
+        m_Draws.clear();
+        m_DrawCount = 0;
+        m_CulledDrawCount = 0;
+        m_PathSyncCount = 0;
+        m_FrameOpen = true;
+        push(Command::clear);
+        m_ClearOperands = m_Commands.size();
+        push(0.f);
+        push(0.f);
+        push(canvasWidth);
+        push(canvasHeight);
+        push(0u);
+        // JS clears in device space.
+        m_State.jsTransformKnown = false;
+    }
+
+    // Ends the frame started by the last clear(), and fills in the area it needs to redraw: the
+    // union of the bounds of every draw that differs from the previous frame's draw in the same
+    // position, or the whole canvas if that's most of it anyway. Called by JS before it replays
+    // the commands.
+    void finishFrame()
+    {
+        if (!m_FrameOpen)
+        {
+            return;
+        }
+        m_FrameOpen = false;
+        std::array<float, 4> damage = m_CanvasBounds;
+        if (!m_FullRedraw)
+        {
+            damage = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+            auto join = [&damage](const std::array<float, 4>& bounds) {
+                damage = {std::min(damage[0], bounds[0]),
+                          std::min(damage[1], bounds[1]),
+                          std::max(damage[2], bounds[2]),
+                          std::max(damage[3], bounds[3])};
+            };
+            size_t count = std::max(m_Draws.size(), m_PrevDraws.size());
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i < m_Draws.size() && i < m_PrevDraws.size() &&
+                    m_Draws[i].key == m_PrevDraws[i].key &&
+                    m_Draws[i].bounds == m_PrevDraws[i].bounds)
+                {
+                    continue;
+                }
+                if (i < m_Draws.size())
+                {
+                    join(m_Draws[i].bounds);
+                }
+                if (i < m_PrevDraws.size())
+                {
+                    join(m_PrevDraws[i].bounds);
+                }
+            }
+            float damageArea = (damage[2] - damage[0]) * (damage[3] - damage[1]);
+            float canvasArea = (m_CanvasBounds[2] - m_CanvasBounds[0]) *
+                               (m_CanvasBounds[3] - m_CanvasBounds[1]);
+            if (damage[0] >= damage[2] || damage[1] >= damage[3])
+            {
+                damage = {0, 0, 0, 0};
+            }
+            else if (damageArea > canvasArea * kMaxDamageFraction)
+            {
+                // Clipping to most of the canvas would cost more than it saves.
+                damage = m_CanvasBounds;
+            }
+        }
+        m_FullRedraw = false;
+        // The clear may have been flushed already, in which case the whole frame was redrawn.
+        if (m_ClearOperands != kNoClear)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                memcpy(&m_Commands[m_ClearOperands + i], &damage[i], sizeof(float));
+            }
+            m_Commands[m_ClearOperands + 4] = static_cast<uint32_t>(m_Commands.size());
+            m_ClearOperands = kNoClear;
+        }
+    }
+
+    // Redraws the whole canvas next frame, for when something else changed its contents (e.g.
+    // reassigning its size, even to the same value).
+    void invalidate() { m_FullRedraw = true; }
+
+    // Number of draws (paths, images and meshes) since the last clear, and how many of them were
+    // skipped because they were entirely outside the canvas or the current clip.
+    uint32_t drawCount() const { return m_DrawCount; }
+    uint32_t culledDrawCount() const { return m_CulledDrawCount; }
+    // Number of paths whose geometry was sent to JS since the last clear, i.e. that were drawn
+    // or clipped to for the first time or after their geometry changed.
+    uint32_t pathSyncCount() const { return m_PathSyncCount; }
+
+    // Image meshes are rasterized at no more than their texture's resolution, times this quality.
+    float meshQuality() const { return m_MeshQuality; }
+    void meshQuality(float value) { m_MeshQuality = value; }
+
+    // View of the recorded commands, which is only valid until the next WASM allocation.
+    emscripten::val commands() const
+    {
+        return emscripten::val(emscripten::typed_memory_view(m_Commands.size(), m_Commands.data()));
+    }
+
+    void resetCommands()
+    {
+        m_Commands.clear();
+        m_ClearOperands = kNoClear;
+        // The context may be reset (i.e. resized) before the next commands are replayed.
+        m_State.jsTransformKnown = false;
+    }
+
+private:
+    // Transforms local bounds, outset by the given amount, into device space.
+    std::array<float, 4> deviceBounds(const std::array<float, 4>& bounds, float outset) const
+    {
+        float l = bounds[0] - outset;
+        float t = bounds[1] - outset;
+        float r = bounds[2] + outset;
+        float b = bounds[3] + outset;
+        float corners[8] = {l, t, r, t, r, b, l, b};
+        return bboxUnrounded(m_State.transform.values(), corners, 8);
+    }
+
+    // True if nothing within the device space bounds can be visible, because they're entirely
+    // outside of the canvas or the current clip (or empty).
+    bool isCulled(const std::array<float, 4>& bounds) const
+    {
+        auto [l, t, r, b] = bounds;
+        const auto& clip = m_State.clipBounds;
+        return l >= r || t >= b || l >= m_CanvasBounds[2] || t >= m_CanvasBounds[3] ||
+               r <= m_CanvasBounds[0] || b <= m_CanvasBounds[1] || l >= clip[2] || t >= clip[3] ||
+               r <= clip[0] || b <= clip[1];
+    }
+
+    // Identifies what a draw puts on the canvas: whatever describes the command itself, along with
+    // the transform and clip it's drawn under.
+    uint64_t drawKey(Command command, const void* data, size_t size) const
+    {
+        uint64_t key = hashBytes64(kHashSeed64, &command, sizeof(command));
+        key = hashBytes64(key, data, size);
+        key = hashBytes64(key, m_State.transform.values(), 6 * sizeof(float));
+        return hashBytes64(key, &m_State.clipHash, sizeof(m_State.clipHash));
+    }
+
+    // Remembers a draw for comparison with the next frame. The bounds are clipped, then rounded
+    // out by an extra pixel for antialiasing.
+    void recordDraw(uint64_t key, const std::array<float, 4>& bounds)
+    {
+        const auto& clip = m_State.clipBounds;
+        const auto& canvas = m_CanvasBounds;
+        m_Draws.push_back({key,
+                           {std::max(floorf(std::max(bounds[0], clip[0])) - 1, canvas[0]),
+                            std::max(floorf(std::max(bounds[1], clip[1])) - 1, canvas[1]),
+                            std::min(ceilf(std::min(bounds[2], clip[2])) + 1, canvas[2]),
+                            std::min(ceilf(std::min(bounds[3], clip[3])) + 1, canvas[3])}});
+    }
+
+    // Records a setTransform if the JS context's transform, at this point in the command stream,
+    // isn't the current one.
+    void syncTransform()
+    {
+        static_assert(sizeof(rive::Mat2D) == 6 * sizeof(float));
+        if (m_State.jsTransformKnown &&
+            memcmp(&m_State.jsTransform, &m_State.transform, sizeof(rive::Mat2D)) == 0)
+        {
+            return;
+        }
+        push(Command::setTransform);
+        for (int i = 0; i < 6; ++i)
+        {
+            push(m_State.transform[i]);
+        }
+        m_State.jsTransform = m_State.transform;
+        m_State.jsTransformKnown = true;
+    }
+
+    void push(Command command) { m_Commands.push_back(static_cast<uint32_t>(command)); }
+    void push(uint32_t word) { m_Commands.push_back(word); }
+    void push(float value)
+    {
+        uint32_t word;
+        memcpy(&word, &value, sizeof(word));
+        m_Commands.push_back(word);
+    }
+
+    std::vector<uint32_t> m_Commands;
+
+    // Saved and restored along with the JS context's state.
+    struct State
+    {
+        rive::Mat2D transform;
+        // The transform the JS context will have when it replays up to this point.
+        rive::Mat2D jsTransform;
+        bool jsTransformKnown = false;
+        // Device space bounds of the current clip.
+        std::array<float, 4> clipBounds = {-INFINITY, -INFINITY, INFINITY, INFINITY};
+        // Identifies the most recent clip, for drawKey().
+        uint64_t clipHash = 0;
+    };
+    State m_State;
+    std::vector<State> m_SaveStack;
+
+    // Damage tracking.
+    struct DrawRecord
+    {
+        uint64_t key;
+        std::array<float, 4> bounds;
+    };
+    static constexpr float kMaxDamageFraction = .5f;
+    static constexpr size_t kNoClear = ~size_t(0);
+    std::vector<DrawRecord> m_Draws;
+    std::vector<DrawRecord> m_PrevDraws;
+    bool m_FrameOpen = false;
+    bool m_FullRedraw = true;
+    size_t m_ClearOperands = kNoClear; // Where the open frame's clear() operands are.
+
+    // Unbounded until the first clear() tells us the canvas size.
+    std::array<float, 4> m_CanvasBounds = {-INFINITY, -INFINITY, INFINITY, INFINITY};
+    uint32_t m_DrawCount = 0;
+    uint32_t m_CulledDrawCount = 0;
+    uint32_t m_PathSyncCount = 0;
+    float m_MeshQuality = 1;
 };
 
 namespace rive
@@ -327,8 +1219,8 @@ class C2DFactory : public Factory
         val renderPath = val::module_property("renderFactory").call<val>("makeRenderPath");
         auto ptr = renderPath.as<RenderPath*>(allow_raw_pointers());
 
-        // It might be faster to do this on the JS side, and just pass up the arrays...
-        // for now, we do it one segment at a time (each turns into an up-call to JS)
+        // Segments are recorded in WASM memory and sent up to JS in one call when the path is
+        // first drawn.
         ptr->fillRule(fr);
         const Vec2D* pts = path.points().data();
         for (auto v : path.verbs())
@@ -395,25 +1287,68 @@ class C2DFactory : public Factory
 EMSCRIPTEN_BINDINGS(RiveWASM_C2D)
 {
     class_<rive::Renderer>("Renderer")
-        .function("save", &RendererWrapper::save, pure_virtual(), allow_raw_pointers())
-        .function("restore", &RendererWrapper::restore, pure_virtual(), allow_raw_pointers())
-        .function("transform", &RendererWrapper::transform, pure_virtual(), allow_raw_pointers())
-        .function("drawPath", &RendererWrapper::drawPath, pure_virtual(), allow_raw_pointers())
-        .function("clipPath", &RendererWrapper::clipPath, pure_virtual(), allow_raw_pointers())
-        .function("align", &RendererWrapper::align, pure_virtual(), allow_raw_pointers())
+        .function("save", &RendererWrapper::save, allow_raw_pointers())
+        .function("restore", &RendererWrapper::restore, allow_raw_pointers())
+        .function("transform", &RendererWrapper::transform, allow_raw_pointers())
+        .function("_transform",
+                  optional_override([](RendererWrapper& self,
+                                       float xx,
+                                       float xy,
+                                       float yx,
+                                       float yy,
+                                       float tx,
+                                       float ty) {
+                      self.transform(rive::Mat2D(xx, xy, yx, yy, tx, ty));
+                  }))
+        .function("drawPath", &RendererWrapper::drawPath, allow_raw_pointers())
+        .function("clipPath", &RendererWrapper::clipPath, allow_raw_pointers())
+        .function("align", &RendererWrapper::align, allow_raw_pointers())
+        .function("_clear", &RendererWrapper::clear)
+        .function("_finishFrame", &RendererWrapper::finishFrame)
+        .function("invalidate", &RendererWrapper::invalidate)
+        .function("drawCount", &RendererWrapper::drawCount)
+        .function("culledDrawCount", &RendererWrapper::culledDrawCount)
+        .function("pathSyncCount", &RendererWrapper::pathSyncCount)
+        .property("meshQuality",
+                  select_overload<float() const>(&RendererWrapper::meshQuality),
+                  select_overload<void(float)>(&RendererWrapper::meshQuality))
+        .function("_commands", &RendererWrapper::commands)
+        .function("_resetCommands", &RendererWrapper::resetCommands)
         .allow_subclass<RendererWrapper>("RendererWrapper");
 
+    function("_resetMeshStaging", optional_override([]() { gMeshStaging.reset(); }));
+    function("_beginMeshAtlas", optional_override([]() { gMeshStaging.beginAtlas(); }));
+    function("_addAtlasMesh",
+             optional_override([](uint32_t firstVertex,
+                                  uint32_t vertexCount,
+                                  uint32_t baseVertex,
+                                  uint32_t indexOffset,
+                                  uint32_t indexCount,
+                                  float xx,
+                                  float xy,
+                                  float yx,
+                                  float yy,
+                                  float tx,
+                                  float ty) {
+                 float m[6] = {xx, xy, yx, yy, tx, ty};
+                 return gMeshStaging.addToAtlas({firstVertex, baseVertex, indexOffset},
+                                                vertexCount,
+                                                indexCount,
+                                                m);
+             }));
+    function("_meshAtlasVertices",
+             optional_override([]() { return gMeshStaging.atlasVertices(); }));
+    function("_meshAtlasUVs", optional_override([]() { return gMeshStaging.atlasUVs(); }));
+    function("_meshAtlasIndices", optional_override([]() { return gMeshStaging.atlasIndices(); }));
+
     class_<rive::RenderPath>("RenderPath")
-        .function("rewind", &RenderPathWrapper::rewind, pure_virtual(), allow_raw_pointers())
-        .function("addPath",
-                  &RenderPathWrapper::addRenderPath,
-                  pure_virtual(),
-                  allow_raw_pointers())
-        .function("fillRule", &RenderPathWrapper::fillRule, pure_virtual())
-        .function("moveTo", &RenderPathWrapper::moveTo, pure_virtual(), allow_raw_pointers())
-        .function("lineTo", &RenderPathWrapper::lineTo, pure_virtual(), allow_raw_pointers())
-        .function("cubicTo", &RenderPathWrapper::cubicTo, pure_virtual(), allow_raw_pointers())
-        .function("close", &RenderPathWrapper::close, pure_virtual(), allow_raw_pointers())
+        .function("rewind", &RenderPathWrapper::rewind, allow_raw_pointers())
+        .function("addPath", &RenderPathWrapper::addRenderPath, allow_raw_pointers())
+        .function("fillRule", select_overload<void(rive::FillRule)>(&RenderPathWrapper::fillRule))
+        .function("moveTo", &RenderPathWrapper::moveTo, allow_raw_pointers())
+        .function("lineTo", &RenderPathWrapper::lineTo, allow_raw_pointers())
+        .function("cubicTo", &RenderPathWrapper::cubicTo, allow_raw_pointers())
+        .function("close", &RenderPathWrapper::close, allow_raw_pointers())
         .allow_subclass<RenderPathWrapper>("RenderPathWrapper");
     enum_<rive::RenderPaintStyle>("RenderPaintStyle")
         .value("fill", rive::RenderPaintStyle::fill)